@@ -0,0 +1,113 @@
+#ifndef ACQUISIZIONE_SENSORE_HPP
+#define ACQUISIZIONE_SENSORE_HPP
+
+#include <DistanceSensor.hpp>
+#include <TriploBuffer.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+#include <utility>
+
+// Misura del sensore con gli istanti della richiesta e della risposta (microsecondi, orologio monotono)
+struct CampioneSensore
+{
+    float distanza = 0;    // mm, come DistanceSensor::getDistanceInMillimeters
+    uint64_t richiesta = 0; // istante della richiesta al sensore
+    uint64_t risposta = 0;  // istante della risposta
+    uint64_t numero = 0;    // progressivo, 0 se non ci sono ancora misure
+};
+
+/*
+    Acquisizione del sensore di distanza in un thread dedicato.
+
+    Ogni lettura del sensore (richiesta sulla seriale e attesa della risposta) richiede un intero giro sulla
+    seriale: il thread legge in continuo alla massima velocità consentita dal sensore, o al più ogni
+    intervalloMinimo, e pubblica ogni misura con i suoi istanti in un TriploBuffer. Il ciclo di controllo
+    prende l'ultima misura con aggiorna() e ultimo() senza attese né lock, quindi il giro sulla seriale non è
+    più dentro il periodo di campionamento. L'età della misura (adesso meno richiesta) è il ritardo del
+    sensore visto dal ciclo.
+
+    Un solo lettore (TriploBuffer): gli altri thread devono leggere il sensore in altro modo, e non mentre
+    l'acquisizione è attiva perché la seriale non è condivisibile. Per lo stesso motivo la curva di calibrazione
+    si cambia con calibra(), applicata dal thread di acquisizione prima della lettura successiva.
+*/
+class AcquisizioneSensore
+{
+private:
+    DistanceSensor &sensore;
+    std::chrono::microseconds intervalloMinimo;
+    TriploBuffer<CampioneSensore> campioni;
+    TriploBuffer<std::pair<float, float>> calibrazioni; // m, q; scritte da calibra(), lette dal thread
+    std::atomic<bool> attiva{false};
+    std::thread thread;
+    uint64_t numero = 0; // usato solo dal thread di acquisizione
+
+    static uint64_t adesso()
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void acquisisci()
+    {
+        auto prossima = std::chrono::steady_clock::now();
+        while (attiva)
+        {
+            if (calibrazioni.aggiorna())
+            {
+                sensore.useCalibrationCurve(calibrazioni.lettura().first, calibrazioni.lettura().second);
+            }
+
+            CampioneSensore &campione = campioni.scrittura();
+            campione.richiesta = adesso();
+            campione.distanza = sensore.getDistanceInMillimeters();
+            campione.risposta = adesso();
+            campione.numero = ++numero;
+            campioni.pubblica();
+
+            // Senza intervallo minimo la richiesta successiva parte subito
+            prossima += intervalloMinimo;
+            std::this_thread::sleep_until(prossima);
+            prossima = std::max(prossima, std::chrono::steady_clock::now());
+        }
+    }
+
+public:
+    explicit AcquisizioneSensore(DistanceSensor &sensore, double intervalloMinimo = 0)
+        : sensore(sensore), intervalloMinimo(std::llround(intervalloMinimo * 1e6)) {}
+
+    ~AcquisizioneSensore() { ferma(); }
+
+    AcquisizioneSensore(const AcquisizioneSensore &) = delete;
+    AcquisizioneSensore &operator=(const AcquisizioneSensore &) = delete;
+
+    void avvia()
+    {
+        if (!attiva.exchange(true))
+        {
+            thread = std::thread(&AcquisizioneSensore::acquisisci, this);
+        }
+    }
+
+    // Attende la fine della lettura in corso (al più il timeout della seriale)
+    void ferma()
+    {
+        if (attiva.exchange(false))
+        {
+            thread.join();
+        }
+    }
+
+    // Un solo thread chiamante: la curva vale dalla lettura successiva
+    void calibra(float m, float q) { calibrazioni.pubblica({m, q}); }
+
+    // Lettore: prende l'ultima misura pubblicata, false se non ce ne sono di nuove dall'ultima chiamata
+    bool aggiorna() { return campioni.aggiorna(); }
+
+    // Lettore: misura presa con aggiorna() (numero 0 se non ce ne sono ancora)
+    const CampioneSensore &ultimo() const { return campioni.lettura(); }
+};
+
+#endif
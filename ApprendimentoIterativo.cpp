@@ -0,0 +1,170 @@
+#include <ApprendimentoIterativo.hpp>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+ApprendimentoIterativo::ApprendimentoIterativo(double tempoCampionamento, const ParametriApprendimentoIterativo &parametri)
+    : parametri(parametri)
+{
+    periodoMinimo = max<size_t>(2, (size_t)lround(parametri.periodoMinimo / tempoCampionamento));
+    periodoMassimo = (size_t)lround(parametri.periodoMassimo / tempoCampionamento);
+    anticipo = (size_t)lround(parametri.anticipo / tempoCampionamento);
+    if (!(tempoCampionamento > 0) || periodoMassimo <= periodoMinimo || !(parametri.sogliaPeriodicita > 0) ||
+        parametri.guadagnoApprendimento < 0 || parametri.campioniConferma == 0)
+    {
+        throw invalid_argument("ApprendimentoIterativo: parametri non validi");
+    }
+    // La finestra contiene sempre almeno un periodo intero
+    finestra = periodoMassimo;
+    storia.assign(finestra + periodoMassimo + 1, 0);
+    differenze.assign(periodoMassimo + 1, 0);
+    compensazioni.assign(periodoMassimo, 0);
+    errori.assign(periodoMassimo, 0);
+    filtrate.assign(periodoMassimo, 0);
+}
+
+double ApprendimentoIterativo::campione(size_t ritardo) const
+{
+    return storia[(testa + ritardo) % storia.size()];
+}
+
+size_t ApprendimentoIterativo::stimaPeriodo() const
+{
+    // Differenza media cumulativa normalizzata: D'(tau) = D(tau) tau / somma D(1 ... tau)
+    double somma = 0;
+    for (size_t tau = 1; tau <= periodoMassimo; tau++)
+    {
+        somma += differenze[tau];
+        if (tau < periodoMinimo || somma <= 0)
+        {
+            continue;
+        }
+        double normalizzata = differenze[tau] * tau / somma;
+        if (normalizzata < parametri.sogliaPeriodicita)
+        {
+            // Scende fino al minimo locale
+            while (tau < periodoMassimo && differenze[tau + 1] < differenze[tau])
+            {
+                tau++;
+            }
+            return tau;
+        }
+    }
+    return 0;
+}
+
+bool ApprendimentoIterativo::stessoPeriodo(size_t a, size_t b) const
+{
+    if (a == 0 || b == 0)
+    {
+        return a == b;
+    }
+    return fabs((double)a - (double)b) <= parametri.tolleranzaPeriodo * max(a, b);
+}
+
+void ApprendimentoIterativo::nuovoPeriodo(size_t nuovo)
+{
+    periodo = nuovo;
+    fase = 0;
+    cicli = 0;
+    fill(compensazioni.begin(), compensazioni.end(), 0);
+}
+
+void ApprendimentoIterativo::aggiornaCompensazione()
+{
+    const double gamma = parametri.guadagnoApprendimento;
+    for (size_t i = 0; i < periodo; i++)
+    {
+        filtrate[i] = compensazioni[i] + gamma * errori[(i + anticipo) % periodo];
+    }
+    // Media mobile centrata sul ciclo (indici modulo il periodo)
+    const size_t m = min(parametri.larghezzaFiltro, (periodo - 1) / 2);
+    for (size_t i = 0; i < periodo; i++)
+    {
+        double somma = 0;
+        for (size_t j = 0; j <= 2 * m; j++)
+        {
+            somma += filtrate[(i + periodo + j - m) % periodo];
+        }
+        compensazioni[i] = somma / (2 * m + 1);
+    }
+}
+
+float ApprendimentoIterativo::compensazione(float errore, float posizioneOstacolo)
+{
+    // Nuovo campione in testa; D(tau) guadagna (x[k] - x[k - tau])^2 e perde il termine uscito dalla finestra
+    testa = (testa == 0) ? storia.size() - 1 : testa - 1;
+    storia[testa] = posizioneOstacolo;
+    campioniRicevuti++;
+    for (size_t tau = 1; tau <= periodoMassimo; tau++)
+    {
+        double entrante = campione(0) - campione(tau);
+        double uscente = campione(finestra) - campione(finestra + tau);
+        differenze[tau] += entrante * entrante - uscente * uscente;
+    }
+    if (campioniRicevuti < storia.size())
+    {
+        // Finestra non ancora piena: i termini uscenti sono gli zeri iniziali, D(tau) va ricalcolata da capo
+        if (campioniRicevuti == storia.size() - 1)
+        {
+            for (size_t tau = 1; tau <= periodoMassimo; tau++)
+            {
+                double somma = 0;
+                for (size_t n = 0; n < finestra; n++)
+                {
+                    double differenza = campione(n) - campione(n + tau);
+                    somma += differenza * differenza;
+                }
+                differenze[tau] = somma;
+            }
+        }
+        return 0;
+    }
+
+    // Cambio di periodo (o fine del moto periodico) solo dopo campioniConferma stime consecutive
+    size_t stima = stimaPeriodo();
+    if (stessoPeriodo(stima, periodo))
+    {
+        conferme = 0;
+    }
+    else
+    {
+        if (conferme == 0 || !stessoPeriodo(stima, periodoCandidato))
+        {
+            periodoCandidato = stima;
+            conferme = 0;
+        }
+        if (++conferme >= parametri.campioniConferma)
+        {
+            nuovoPeriodo(periodoCandidato);
+            conferme = 0;
+        }
+    }
+
+    if (periodo == 0)
+    {
+        return 0;
+    }
+    float uscita = (float)compensazioni[fase];
+    errori[fase] = errore;
+    if (++fase == periodo)
+    {
+        aggiornaCompensazione();
+        fase = 0;
+        cicli++;
+    }
+    return uscita;
+}
+
+void ApprendimentoIterativo::reset()
+{
+    fill(storia.begin(), storia.end(), 0);
+    fill(differenze.begin(), differenze.end(), 0);
+    testa = 0;
+    campioniRicevuti = 0;
+    periodoCandidato = 0;
+    conferme = 0;
+    nuovoPeriodo(0);
+}
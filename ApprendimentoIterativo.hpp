@@ -0,0 +1,86 @@
+#ifndef APPRENDIMENTO_ITERATIVO_HPP
+#define APPRENDIMENTO_ITERATIVO_HPP
+
+#include <cstddef>
+#include <vector>
+
+// Parametri del controllo ad apprendimento iterativo e del riconoscimento del periodo
+struct ParametriApprendimentoIterativo
+{
+    double periodoMinimo = 0.5;         // s, periodi più corti non sono cercati
+    double periodoMassimo = 6.0;        // s, dimensiona tutti i buffer (riconoscimento dopo 2 periodoMassimo)
+    double sogliaPeriodicita = 0.1;     // differenza normalizzata (YIN) sotto la quale il moto è periodico
+    double tolleranzaPeriodo = 0.03;    // variazione relativa del periodo che fa ripartire l'apprendimento
+    std::size_t campioniConferma = 25;  // campioni consecutivi con un nuovo periodo (o senza periodo) prima di cambiare
+    double guadagnoApprendimento = 2.0; // (mm/s)/mm, correzione della compensazione per mm di errore
+    double anticipo = 0.3;              // s, anticipo dell'errore nella legge (ritardo del Meca500 e fase dell'anello)
+    std::size_t larghezzaFiltro = 3;    // campioni per lato della media mobile centrata (filtro Q a fase nulla)
+};
+
+/*
+    Controllo ad apprendimento iterativo (ILC) sopra il regolatore in retroazione, per ostacoli che ripetono
+    sempre lo stesso profilo.
+
+    Riconoscimento del periodo: sulla posizione dell'ostacolo nel mondo (posizione del robot meno la distanza
+    misurata) è calcolata a ogni campione la funzione differenza di YIN
+
+        D(tau) = somma sulla finestra di (x[k] - x[k - tau])^2,   D'(tau) = D(tau) tau / (D(1) + ... + D(tau))
+
+    aggiornata in modo incrementale (ogni nuovo campione aggiunge un termine e toglie il più vecchio per ogni
+    tau, O(periodoMassimo / Tc) per campione). Il periodo è il primo minimo locale di D' sotto sogliaPeriodicita:
+    i multipli del periodo, anch'essi minimi, vengono dopo.
+
+    Apprendimento: con il periodo P (campioni) la compensazione è un vettore u[0 ... P-1] sommato all'uscita del
+    regolatore alla fase attuale del ciclo. Alla fine di ogni ciclo
+
+        u[i] = Q(u[i] + guadagnoApprendimento e[i + anticipo])
+
+    con e l'errore registrato nel ciclo (indici modulo P: il moto è periodico) e Q la media mobile centrata,
+    a fase nulla perché applicata al ciclo intero. L'anticipo compensa il ritardo tra compensazione ed errore;
+    Q limita l'apprendimento alle frequenze che l'anello segue senza amplificarle da un ciclo all'altro.
+    Così l'errore periodico cala ciclo dopo ciclo anche oltre la banda della retroazione.
+
+    Se il periodo cambia oltre tolleranzaPeriodo o il moto smette di essere periodico per campioniConferma
+    campioni la compensazione è azzerata e l'apprendimento riparte. Tutti i buffer sono allocati nel
+    costruttore: un campione non alloca.
+*/
+class ApprendimentoIterativo
+{
+private:
+    ParametriApprendimentoIterativo parametri;
+    std::size_t periodoMinimo, periodoMassimo, finestra, anticipo;
+
+    // Riconoscimento del periodo: storia circolare delle posizioni (finestra + periodoMassimo + 1 campioni)
+    std::vector<double> storia;
+    std::size_t testa = 0;
+    std::size_t campioniRicevuti = 0;
+    std::vector<double> differenze; // D(tau), tau = 0 ... periodoMassimo
+    std::size_t periodoCandidato = 0;
+    std::size_t conferme = 0;
+
+    // Apprendimento
+    std::vector<double> compensazioni, errori, filtrate;
+    std::size_t periodo = 0; // 0: moto non periodico, nessuna compensazione
+    std::size_t fase = 0;
+    std::size_t cicli = 0;
+
+    double campione(std::size_t ritardo) const; // posizione di ritardo campioni fa
+    std::size_t stimaPeriodo() const;           // 0 se il moto non è periodico
+    bool stessoPeriodo(std::size_t a, std::size_t b) const; // uguali entro tolleranzaPeriodo (0 solo con 0)
+    void nuovoPeriodo(std::size_t nuovo);
+    void aggiornaCompensazione();
+
+public:
+    ApprendimentoIterativo(double tempoCampionamento, const ParametriApprendimentoIterativo &parametri = ParametriApprendimentoIterativo());
+
+    // Velocità da sommare a quella del regolatore, con l'errore attuale e la posizione dell'ostacolo nel mondo (mm)
+    float compensazione(float errore, float posizioneOstacolo);
+
+    // Ostacolo perso o ciclo in pausa: storia e compensazione ripartono da zero
+    void reset();
+
+    std::size_t getPeriodo() const { return periodo; } // campioni, 0 se non riconosciuto
+    std::size_t getCicli() const { return cicli; }     // cicli appresi con il periodo attuale
+};
+
+#endif
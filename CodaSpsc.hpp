@@ -0,0 +1,53 @@
+#ifndef CODA_SPSC_HPP
+#define CODA_SPSC_HPP
+
+#include <atomic>
+#include <cstddef>
+
+/*
+    Coda limitata lock-free tra un solo thread produttore e un solo thread consumatore.
+
+    Anello di Capacita elementi (potenza di 2) con due indici che crescono senza limite: il produttore scrive
+    l'elemento e poi pubblica la coda (release), il consumatore legge l'elemento e poi libera la testa. Ciascun
+    indice è scritto da un solo thread e sta su una propria linea di cache; inserisci() ed estrai() non
+    attendono e non allocano: con la coda piena inserisci() ritorna false e il produttore decide cosa fare.
+*/
+template <typename T, std::size_t Capacita>
+class CodaSpsc
+{
+    static_assert(Capacita > 0 && (Capacita & (Capacita - 1)) == 0, "CodaSpsc: la capacità deve essere una potenza di 2");
+
+private:
+    T elementi[Capacita];
+    alignas(64) std::atomic<std::size_t> testa{0}; // prossimo elemento da estrarre, scritta dal consumatore
+    alignas(64) std::atomic<std::size_t> coda{0};  // prossimo elemento da inserire, scritta dal produttore
+
+public:
+    // Produttore: false se la coda è piena
+    bool inserisci(const T &valore)
+    {
+        std::size_t c = coda.load(std::memory_order_relaxed);
+        if (c - testa.load(std::memory_order_acquire) == Capacita)
+        {
+            return false;
+        }
+        elementi[c & (Capacita - 1)] = valore;
+        coda.store(c + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumatore: false se la coda è vuota
+    bool estrai(T &valore)
+    {
+        std::size_t t = testa.load(std::memory_order_relaxed);
+        if (t == coda.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        valore = elementi[t & (Capacita - 1)];
+        testa.store(t + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+#endif
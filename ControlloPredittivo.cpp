@@ -0,0 +1,358 @@
+#include <ControlloPredittivo.hpp>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+#define PESO_QUADRATICO_VIOLAZIONE 1.0  // per mm^2 di violazione, solo per avere H definita positiva
+#define TOLLERANZA_PASSO 1e-9           // passo nullo, relativo al valore delle variabili
+#define TOLLERANZA_MOLTIPLICATORI 1e-9
+#define PIVOT_MINIMO 1e-12
+
+ControlloPredittivo::ControlloPredittivo(const ParametriMeca500 &impianto, double tempoCampionamento, const ParametriControlloPredittivo &parametri)
+    : parametri(parametri), velocitaMassima(impianto.velocitaMassima), variazioneMassima(parametri.accelerazioneMassima * tempoCampionamento),
+      N(parametri.orizzontePredizione), Nu(parametri.orizzonteControllo), V(parametri.orizzonteControllo + 1),
+      M(2 * parametri.orizzonteControllo + 2 * parametri.orizzontePredizione + 1),
+      modello(impianto, tempoCampionamento, 0), modelloPrecedente(modello), predizione(modello)
+{
+    if (N == 0 || Nu == 0 || Nu > N || !(parametri.accelerazioneMassima > 0) || !(parametri.limiteInferiore < parametri.limiteSuperiore) ||
+        !(parametri.pesoErrore > 0) || parametri.pesoVariazione < 0 || !(parametri.pesoViolazione > 0) ||
+        parametri.iterazioniMassime == 0)
+    {
+        throw invalid_argument("ControlloPredittivo: parametri non validi");
+    }
+
+    // Risposta della posizione a un impulso unitario di velocità comandata: h[m] dopo m + 1 periodi
+    vector<double> impulso(N);
+    ModelloMeca500 risposta(impianto, tempoCampionamento, 0);
+    for (size_t m = 0; m < N; m++)
+    {
+        risposta.passo(m == 0 ? 1 : 0);
+        impulso[m] = risposta.getPosizione();
+    }
+
+    // S[i][j]: posizione dopo i + 1 periodi dovuta a z_j, applicata al periodo j (l'ultima da Nu - 1 fino a N - 1)
+    S.assign(N * Nu, 0);
+    for (size_t i = 0; i < N; i++)
+    {
+        for (size_t t = 0; t <= i; t++)
+        {
+            S[i * Nu + min(t, Nu - 1)] += impulso[i - t];
+        }
+    }
+
+    // A (variabili z_0 ... z_Nu-1 e violazione s): velocità, variazioni (la prima rispetto all'ultima velocità
+    // applicata, nei limiti), posizioni predette meno s (limite superiore), più s (limite inferiore) e s >= 0
+    A.assign(M * V, 0);
+    for (size_t j = 0; j < Nu; j++)
+    {
+        A[j * V + j] = 1;
+        A[(Nu + j) * V + j] = 1;
+        if (j > 0)
+        {
+            A[(Nu + j) * V + j - 1] = -1;
+        }
+    }
+    for (size_t i = 0; i < N; i++)
+    {
+        for (size_t j = 0; j < Nu; j++)
+        {
+            A[(2 * Nu + i) * V + j] = S[i * Nu + j];
+            A[(2 * Nu + N + i) * V + j] = S[i * Nu + j];
+        }
+        A[(2 * Nu + i) * V + Nu] = -1;
+        A[(2 * Nu + N + i) * V + Nu] = 1;
+    }
+    A[(M - 1) * V + Nu] = 1;
+
+    // H = pesoErrore S'S + pesoVariazione D'D sulle velocità, la violazione ha un costo lineare più un termine
+    // quadratico piccolo che rende H definita positiva
+    H.assign(V * V, 0);
+    for (size_t r = 0; r < Nu; r++)
+    {
+        for (size_t c = 0; c < Nu; c++)
+        {
+            double ss = 0, dd = 0;
+            for (size_t i = 0; i < N; i++)
+            {
+                ss += S[i * Nu + r] * S[i * Nu + c];
+            }
+            for (size_t i = Nu; i < 2 * Nu; i++)
+            {
+                dd += A[i * V + r] * A[i * V + c];
+            }
+            H[r * V + c] = parametri.pesoErrore * ss + parametri.pesoVariazione * dd;
+        }
+    }
+    H[Nu * V + Nu] = PESO_QUADRATICO_VIOLAZIONE;
+
+    rispostaLibera.assign(N, 0);
+    q.assign(V, 0);
+    q[Nu] = parametri.pesoViolazione;
+    inferiore.assign(M, 0);
+    superiore.assign(M, 0);
+    x.assign(V, 0);
+    gradiente.assign(V, 0);
+    soluzione.assign(2 * V, 0);
+    sistema.assign(2 * V * (2 * V + 1), 0);
+    attivi.assign(V, 0);
+    segniAttivi.assign(V, 0);
+}
+
+double ControlloPredittivo::riga(size_t r, const vector<double> &vettore) const
+{
+    double prodotto = 0;
+    for (size_t j = 0; j < V; j++)
+    {
+        prodotto += A[r * V + j] * vettore[j];
+    }
+    return prodotto;
+}
+
+bool ControlloPredittivo::risolviKkt()
+{
+    // [H C'; C 0] [p; mu] = [-(H x + q); 0], C righe attive con il segno del limite (+1 superiore, -1 inferiore)
+    const size_t n = V + numeroAttivi, colonne = n + 1;
+    for (size_t r = 0; r < n; r++)
+    {
+        for (size_t c = 0; c < colonne; c++)
+        {
+            double valore = 0;
+            if (r < V && c < V)
+                valore = H[r * V + c];
+            else if (r < V && c < n)
+                valore = segniAttivi[c - V] * A[attivi[c - V] * V + r];
+            else if (r >= V && c < V)
+                valore = segniAttivi[r - V] * A[attivi[r - V] * V + c];
+            else if (r < V && c == n)
+                valore = -gradiente[r];
+            sistema[r * colonne + c] = valore;
+        }
+    }
+
+    // Eliminazione di Gauss con pivot parziale (al massimo 2V incognite)
+    for (size_t k = 0; k < n; k++)
+    {
+        size_t pivot = k;
+        for (size_t r = k + 1; r < n; r++)
+        {
+            if (fabs(sistema[r * colonne + k]) > fabs(sistema[pivot * colonne + k]))
+                pivot = r;
+        }
+        if (fabs(sistema[pivot * colonne + k]) < PIVOT_MINIMO)
+        {
+            return false;
+        }
+        if (pivot != k)
+        {
+            for (size_t c = k; c < colonne; c++)
+                swap(sistema[k * colonne + c], sistema[pivot * colonne + c]);
+        }
+        for (size_t r = k + 1; r < n; r++)
+        {
+            const double fattore = sistema[r * colonne + k] / sistema[k * colonne + k];
+            for (size_t c = k; c < colonne; c++)
+                sistema[r * colonne + c] -= fattore * sistema[k * colonne + c];
+        }
+    }
+    for (size_t k = n; k-- > 0;)
+    {
+        double somma = sistema[k * colonne + n];
+        for (size_t c = k + 1; c < n; c++)
+        {
+            somma -= sistema[k * colonne + c] * soluzione[c];
+        }
+        soluzione[k] = somma / sistema[k * colonne + k];
+    }
+    return true;
+}
+
+size_t ControlloPredittivo::risolviQP()
+{
+    // Metodo primale degli insiemi attivi (Nocedal-Wright 16.3) da x ammissibile: a ogni iterazione il passo
+    // verso il minimo con i vincoli attivi come uguaglianze, fermato dal primo vincolo che blocca
+    numeroAttivi = 0;
+    for (size_t iterazione = 1; iterazione <= parametri.iterazioniMassime; iterazione++)
+    {
+        double scala = 1;
+        for (size_t j = 0; j < V; j++)
+        {
+            gradiente[j] = q[j];
+            for (size_t k = 0; k < V; k++)
+            {
+                gradiente[j] += H[j * V + k] * x[k];
+            }
+            scala = max(scala, fabs(x[j]));
+        }
+        if (!risolviKkt())
+        {
+            return iterazione;
+        }
+
+        double passoMassimo = 0;
+        for (size_t j = 0; j < V; j++)
+        {
+            passoMassimo = max(passoMassimo, fabs(soluzione[j]));
+        }
+        // Con V vincoli attivi indipendenti il passo è nullo: lo si forza per non superare lo spazio preallocato
+        if (passoMassimo <= TOLLERANZA_PASSO * scala || numeroAttivi == V)
+        {
+            // Minimo con i vincoli attivi: ottimo se tutti i moltiplicatori sono non negativi, altrimenti
+            // si rilascia il vincolo con il moltiplicatore più negativo
+            size_t rilasciato = numeroAttivi;
+            double minimo = -TOLLERANZA_MOLTIPLICATORI;
+            for (size_t k = 0; k < numeroAttivi; k++)
+            {
+                if (soluzione[V + k] < minimo)
+                {
+                    minimo = soluzione[V + k];
+                    rilasciato = k;
+                }
+            }
+            if (rilasciato == numeroAttivi)
+            {
+                return iterazione;
+            }
+            numeroAttivi--;
+            attivi[rilasciato] = attivi[numeroAttivi];
+            segniAttivi[rilasciato] = segniAttivi[numeroAttivi];
+            continue;
+        }
+
+        // Passo più lungo possibile fino a 1 lungo la direzione, senza uscire dai limiti
+        double lunghezza = 1;
+        size_t bloccante = M;
+        double segnoBloccante = 0;
+        for (size_t r = 0; r < M; r++)
+        {
+            if (find(attivi.begin(), attivi.begin() + numeroAttivi, r) != attivi.begin() + numeroAttivi)
+            {
+                continue;
+            }
+            const double direzione = riga(r, soluzione);
+            if (fabs(direzione) < PIVOT_MINIMO)
+            {
+                continue;
+            }
+            const double limite = (direzione > 0) ? superiore[r] : inferiore[r];
+            if (!isfinite(limite))
+            {
+                continue;
+            }
+            const double distanza = max(0.0, (limite - riga(r, x)) / direzione);
+            if (distanza < lunghezza)
+            {
+                lunghezza = distanza;
+                bloccante = r;
+                segnoBloccante = (direzione > 0) ? 1 : -1;
+            }
+        }
+        for (size_t j = 0; j < V; j++)
+        {
+            x[j] += lunghezza * soluzione[j];
+        }
+        if (bloccante < M)
+        {
+            attivi[numeroAttivi] = bloccante;
+            segniAttivi[numeroAttivi] = segnoBloccante;
+            numeroAttivi++;
+        }
+    }
+    return parametri.iterazioniMassime;
+}
+
+float ControlloPredittivo::calculate_output(float errore, float posizione)
+{
+    // Risposta libera dalla posizione misurata, con le velocità già in coda per il ritardo
+    modello.setPosizione(posizione);
+    predizione = modello;
+    for (size_t i = 0; i < N; i++)
+    {
+        predizione.passo(0);
+        rispostaLibera[i] = predizione.getPosizione() - posizione;
+    }
+
+    // q = -pesoErrore S'(errore - risposta libera) - pesoVariazione u[k - 1] e0, pesoViolazione per s
+    for (size_t j = 0; j < Nu; j++)
+    {
+        double somma = 0;
+        for (size_t i = 0; i < N; i++)
+        {
+            somma += S[i * Nu + j] * (errore - rispostaLibera[i]);
+        }
+        q[j] = -parametri.pesoErrore * somma;
+    }
+    q[0] -= parametri.pesoVariazione * ultimaUscita;
+
+    for (size_t j = 0; j < Nu; j++)
+    {
+        inferiore[j] = -velocitaMassima;
+        superiore[j] = velocitaMassima;
+        inferiore[Nu + j] = -variazioneMassima;
+        superiore[Nu + j] = variazioneMassima;
+    }
+    inferiore[Nu] += ultimaUscita;
+    superiore[Nu] += ultimaUscita;
+    for (size_t i = 0; i < N; i++)
+    {
+        inferiore[2 * Nu + i] = -INFINITY;
+        superiore[2 * Nu + i] = parametri.limiteSuperiore - posizione - rispostaLibera[i];
+        inferiore[2 * Nu + N + i] = parametri.limiteInferiore - posizione - rispostaLibera[i];
+        superiore[2 * Nu + N + i] = INFINITY;
+    }
+    inferiore[M - 1] = 0;
+    superiore[M - 1] = INFINITY;
+
+    // Partenza a caldo ammissibile: soluzione precedente traslata di un campione, riportata nei limiti di
+    // velocità e variazione, con la violazione s che basta per le posizioni
+    double precedente = ultimaUscita;
+    for (size_t j = 0; j < Nu; j++)
+    {
+        const double proposta = x[min(j + 1, Nu - 1)];
+        x[j] = clamp(clamp(proposta, precedente - variazioneMassima, precedente + variazioneMassima), -velocitaMassima, velocitaMassima);
+        precedente = x[j];
+    }
+    x[Nu] = 0;
+    for (size_t i = 0; i < N; i++)
+    {
+        double spostamento = 0;
+        for (size_t j = 0; j < Nu; j++)
+        {
+            spostamento += S[i * Nu + j] * x[j];
+        }
+        x[Nu] = max({x[Nu], spostamento - superiore[2 * Nu + i], inferiore[2 * Nu + N + i] - spostamento});
+    }
+    ultimeIterazioni = risolviQP();
+
+    // Limiti di velocità e accelerazione garantiti anche se il risolutore si è fermato prima dell'ottimo
+    double uscita = clamp(x[0], ultimaUscita - variazioneMassima, ultimaUscita + variazioneMassima);
+    uscita = clamp(uscita, -velocitaMassima, velocitaMassima);
+
+    modelloPrecedente = modello;
+    modello.passo(uscita);
+    ultimaUscita = uscita;
+    return uscita;
+}
+
+void ControlloPredittivo::applica(float uscitaApplicata)
+{
+    modello = modelloPrecedente;
+    modello.passo(uscitaApplicata);
+    ultimaUscita = uscitaApplicata;
+}
+
+void ControlloPredittivo::inizializza(float errore, float uscita)
+{
+    // L'errore non serve: la predizione riparte dalla posizione misurata al prossimo passo
+    modello.reset(modello.getPosizione(), uscita);
+    modelloPrecedente = modello;
+    ultimaUscita = uscita;
+    fill(x.begin(), x.begin() + Nu, uscita);
+    x[Nu] = 0;
+}
+
+void ControlloPredittivo::reset()
+{
+    inizializza(0, 0);
+}
@@ -0,0 +1,97 @@
+#ifndef CONTROLLO_PREDITTIVO_HPP
+#define CONTROLLO_PREDITTIVO_HPP
+
+#include <cstddef>
+#include <vector>
+#include <ModelloMeca500.hpp>
+
+// Parametri del controllo predittivo, con i limiti di Robot (POS_LIMIT_INF/SUP) e del Meca500
+struct ParametriControlloPredittivo
+{
+    std::size_t orizzontePredizione = 25; // N campioni predetti (0.5 s a 50 Hz, oltre il ritardo più la costante di tempo)
+    std::size_t orizzonteControllo = 5;   // Nu velocità libere, l'ultima resta costante fino a N
+    double pesoErrore = 1.0;              // per mm^2 di errore predetto
+    double pesoVariazione = 1e-3;         // per (mm/s)^2 di variazione della velocità comandata
+    double pesoViolazione = 1e4;          // per mm oltre i limiti di posizione (vincolo morbido esatto)
+    double accelerazioneMassima = 2000;   // mm/s^2, variazione massima della velocità comandata
+    double limiteInferiore = 30;          // mm, Robot::POS_LIMIT_INF
+    double limiteSuperiore = 200;         // mm, Robot::POS_LIMIT_SUP
+    std::size_t iterazioniMassime = 50;   // iterazioni del metodo degli insiemi attivi per passo
+};
+
+/*
+    Controllo predittivo (MPC) della distanza con vincoli su velocità, accelerazione e posizione, da usare al
+    posto del regolatore lineare nel ciclo di controllo.
+
+    La predizione usa il modello identificato del Meca500 (ModelloMeca500, con il ritardo frazionario) in forma
+    condensata: le posizioni future sono la risposta libera (copia del modello interno fatta evolvere con
+    velocità nulla) più S z, con z le Nu velocità da scegliere. Con l'ostacolo supposto fermo sull'orizzonte
+    l'errore predetto è errore - (posizione predetta - posizione attuale), e il problema è il QP
+
+        min 1/2 x' H x + q' x    con    l <= A x <= u,    x = (z, s)
+
+    dove H = pesoErrore S'S + pesoVariazione D'D (D differenze delle velocità) e A impila velocità, variazioni
+    e posizioni predette. I limiti di posizione sono morbidi: s >= 0 è la violazione massima, pesata
+    linearmente con pesoViolazione, così s = 0 quando i limiti si possono rispettare e il QP resta ammissibile
+    quando il robot è già troppo veloce per fermarsi in tempo con l'accelerazione massima (frena al massimo).
+
+    S, H e A dipendono solo dal modello e sono calcolate nel costruttore; a ogni passo cambiano solo q e i
+    limiti. Il QP ha Nu + 1 variabili ed è risolto esattamente con il metodo primale degli insiemi attivi,
+    partendo dalla soluzione del passo precedente traslata di un campione (sempre ammissibile grazie a s):
+    poche iterazioni, ognuna con un sistema KKT di al massimo 2 (Nu + 1) incognite, su vettori preallocati
+    e senza allocazioni.
+
+    Il modello interno è riallineato a ogni passo con la posizione misurata del robot (niente errore a regime
+    con ostacolo fermo anche se il modello non è esatto) e fatto evolvere con la velocità effettivamente
+    inviata (applica()), come l'anti-windup di RegolatoreStatoSpazio. La velocità restituita rispetta sempre
+    i limiti di velocità e accelerazione; la limitazione ai limiti di posizione di test_regolatore.cpp resta
+    come protezione.
+*/
+class ControlloPredittivo
+{
+private:
+    ParametriControlloPredittivo parametri;
+    double velocitaMassima;
+    double variazioneMassima; // accelerazioneMassima * Tc
+    std::size_t N, Nu, V, M;  // orizzonti, variabili (Nu + 1) e vincoli (2 Nu + 2 N + 1)
+
+    ModelloMeca500 modello;           // stato stimato del robot dopo l'ultima velocità applicata
+    ModelloMeca500 modelloPrecedente; // prima dell'ultimo passo, per sostituire la velocità calcolata con quella applicata
+    ModelloMeca500 predizione;        // copia per la risposta libera
+    double ultimaUscita = 0;
+
+    // Matrici costanti, per righe: S (N x Nu), A (M x V), H (V x V)
+    std::vector<double> S, A, H;
+    // QP del passo attuale e spazio di lavoro del risolutore, allocati nel costruttore
+    std::vector<double> rispostaLibera, q, inferiore, superiore, x;
+    std::vector<double> gradiente, soluzione, sistema;
+    std::vector<std::size_t> attivi; // righe di A nell'insieme attivo
+    std::vector<double> segniAttivi; // +1 limite superiore, -1 inferiore
+    std::size_t numeroAttivi = 0;
+    std::size_t ultimeIterazioni = 0;
+
+    double riga(std::size_t r, const std::vector<double> &vettore) const; // riga r di A per il vettore
+    bool risolviKkt(); // passo e moltiplicatori in soluzione, false se il sistema è singolare
+    std::size_t risolviQP();
+
+public:
+    ControlloPredittivo(const ParametriMeca500 &impianto, double tempoCampionamento,
+                        const ParametriControlloPredittivo &parametri = ParametriControlloPredittivo());
+
+    // Velocità da comandare con l'errore attuale (riferimento - distanza misurata) e la posizione misurata del
+    // robot (mm). Il modello interno evolve supponendo che venga applicata così com'è.
+    float calculate_output(float errore, float posizione);
+
+    // Da chiamare dopo calculate_output con la velocità effettivamente inviata al robot
+    void applica(float uscitaApplicata);
+
+    // Robot a regime con la velocità uscita (ripartenza dopo una pausa o l'ostacolo fuori portata)
+    void inizializza(float errore, float uscita);
+
+    void reset();
+
+    // Iterazioni del risolutore nell'ultimo passo (iterazioniMassime se si è fermato prima dell'ottimo)
+    std::size_t getUltimeIterazioni() const { return ultimeIterazioni; }
+};
+
+#endif
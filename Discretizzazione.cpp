@@ -0,0 +1,400 @@
+#include <Discretizzazione.hpp>
+#include <Polinomi.hpp>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+// Radici considerate nell'origine dalla discretizzazione a poli e zeri corrispondenti
+#define TOLLERANZA_ORIGINE 1e-12
+// Parte immaginaria relativa ammessa nei coefficienti di un polinomio con radici coniugate
+#define TOLLERANZA_IMMAGINARIA 1e-9
+
+namespace
+{
+    // Matrice quadrata memorizzata per righe
+    struct Matrice
+    {
+        size_t n;
+        vector<double> valori;
+
+        explicit Matrice(size_t n, double diagonale = 0) : n(n), valori(n * n, 0)
+        {
+            for (size_t i = 0; i < n; i++)
+            {
+                valori[i * n + i] = diagonale;
+            }
+        }
+        double &operator()(size_t i, size_t j) { return valori[i * n + j]; }
+        double operator()(size_t i, size_t j) const { return valori[i * n + j]; }
+    };
+
+    Matrice prodotto(const Matrice &a, const Matrice &b)
+    {
+        Matrice c(a.n);
+        for (size_t i = 0; i < a.n; i++)
+            for (size_t k = 0; k < a.n; k++)
+                for (size_t j = 0; j < a.n; j++)
+                    c(i, j) += a(i, k) * b(k, j);
+        return c;
+    }
+
+    // e^M con scalatura e quadrature successive della serie di Taylor
+    Matrice esponenziale(Matrice m)
+    {
+        double norma = 0;
+        for (size_t i = 0; i < m.n; i++)
+        {
+            double riga = 0;
+            for (size_t j = 0; j < m.n; j++)
+                riga += fabs(m(i, j));
+            norma = max(norma, riga);
+        }
+        int quadrature = (norma > 0.5) ? (int)ceil(log2(norma / 0.5)) : 0;
+        for (double &v : m.valori)
+            v = ldexp(v, -quadrature);
+
+        Matrice risultato(m.n, 1), termine(m.n, 1);
+        for (int k = 1; k <= 20; k++)
+        {
+            termine = prodotto(termine, m);
+            for (size_t i = 0; i < termine.valori.size(); i++)
+            {
+                termine.valori[i] /= k;
+                risultato.valori[i] += termine.valori[i];
+            }
+        }
+        for (int q = 0; q < quadrature; q++)
+            risultato = prodotto(risultato, risultato);
+        return risultato;
+    }
+
+    // Coefficienti (potenze decrescenti) di det(zI - A) con il metodo di Faddeev-LeVerrier
+    vector<double> polinomioCaratteristico(const Matrice &a)
+    {
+        vector<double> c(a.n + 1, 0);
+        c[0] = 1;
+        Matrice m(a.n);
+        for (size_t k = 1; k <= a.n; k++)
+        {
+            m = prodotto(a, m);
+            for (size_t i = 0; i < a.n; i++)
+                m(i, i) += c[k - 1];
+            Matrice am = prodotto(a, m);
+            double traccia = 0;
+            for (size_t i = 0; i < a.n; i++)
+                traccia += am(i, i);
+            c[k] = -traccia / k;
+        }
+        return c;
+    }
+
+    // Polinomio reale monico con le radici date, che devono essere reali o in coppie coniugate
+    vector<double> polinomioReale(const vector<complex<double>> &radici)
+    {
+        vector<complex<double>> complessi = polinomioDaRadici(radici);
+        vector<double> reali(complessi.size());
+        for (size_t i = 0; i < complessi.size(); i++)
+        {
+            if (fabs(complessi[i].imag()) > TOLLERANZA_IMMAGINARIA * max(1.0, fabs(complessi[i].real())))
+            {
+                throw invalid_argument("Discretizzazione: zeri e poli complessi devono essere in coppie coniugate");
+            }
+            reali[i] = complessi[i].real();
+        }
+        return reali;
+    }
+
+    double parteReale(complex<double> valore)
+    {
+        if (fabs(valore.imag()) > TOLLERANZA_IMMAGINARIA * max(1.0, fabs(valore.real())))
+        {
+            throw invalid_argument("Discretizzazione: zeri e poli complessi devono essere in coppie coniugate");
+        }
+        return valore.real();
+    }
+
+    // H(z) = numeratore(z) / denominatore(z), denominatore monico di grado n e numeratore di grado <= n
+    CoefficientiRegolatore coefficientiDa(vector<double> numeratore, const vector<double> &denominatore)
+    {
+        const size_t n = denominatore.size() - 1;
+        numeratore.insert(numeratore.begin(), n + 1 - numeratore.size(), 0.0);
+
+        // Divisione per z^n: y[k] = -a1 y[k-1] - ... - an y[k-n] + b0 u[k] + ... + bn u[k-n]
+        CoefficientiRegolatore coefficienti;
+        coefficienti.input_coeff = numeratore;
+        for (size_t i = 1; i <= n; i++)
+        {
+            coefficienti.output_coeff.push_back(-denominatore[i]);
+        }
+        return coefficienti;
+    }
+
+    CoefficientiRegolatore tustin(const FunzioneTrasferimentoContinua &f, double Tc, double pulsazionePrewarp)
+    {
+        if (pulsazionePrewarp * Tc >= M_PI)
+        {
+            throw invalid_argument("Discretizzazione: la pulsazione di prewarp deve essere inferiore a quella di Nyquist");
+        }
+        const double k = (pulsazionePrewarp > 0) ? pulsazionePrewarp / tan(pulsazionePrewarp * Tc / 2) : 2 / Tc;
+
+        // (s - a) = (k - a) (z - (k + a) / (k - a)) / (z + 1)
+        complex<double> guadagno = f.guadagno;
+        vector<complex<double>> zeri, poli;
+        for (const complex<double> &z : f.zeri)
+        {
+            guadagno *= k - z;
+            zeri.push_back((k + z) / (k - z));
+        }
+        for (const complex<double> &p : f.poli)
+        {
+            guadagno /= k - p;
+            poli.push_back((k + p) / (k - p));
+        }
+        zeri.insert(zeri.end(), f.poli.size() - f.zeri.size(), -1.0);
+
+        vector<double> numeratore = polinomioReale(zeri);
+        for (double &c : numeratore)
+            c *= parteReale(guadagno);
+        return coefficientiDa(numeratore, polinomioReale(poli));
+    }
+
+    CoefficientiRegolatore poliZeri(const FunzioneTrasferimentoContinua &f, double Tc)
+    {
+        // Guadagno in continua: (s - a) vale -a in s = 0 e (z - e^(a Tc)) vale 1 - e^(a Tc) in z = 1,
+        // le singolarità nell'origine s corrispondono a (z - 1) / Tc e gli zeri in z = 0 valgono 1
+        complex<double> guadagno = f.guadagno;
+        vector<complex<double>> zeri, poli;
+        for (const complex<double> &z : f.zeri)
+        {
+            zeri.push_back(exp(z * Tc));
+            guadagno *= (abs(z) < TOLLERANZA_ORIGINE) ? 1 / Tc : -z / (1.0 - zeri.back());
+        }
+        for (const complex<double> &p : f.poli)
+        {
+            poli.push_back(exp(p * Tc));
+            guadagno *= (abs(p) < TOLLERANZA_ORIGINE) ? Tc : (1.0 - poli.back()) / -p;
+        }
+        zeri.insert(zeri.end(), f.poli.size() - f.zeri.size(), 0.0);
+
+        vector<double> numeratore = polinomioReale(zeri);
+        for (double &c : numeratore)
+            c *= parteReale(guadagno);
+        return coefficientiDa(numeratore, polinomioReale(poli));
+    }
+
+    CoefficientiRegolatore zoh(const FunzioneTrasferimentoContinua &f, double Tc)
+    {
+        vector<double> denominatore = polinomioReale(f.poli);
+        vector<double> numeratore = polinomioReale(f.zeri);
+        const size_t n = f.poli.size();
+        for (double &c : numeratore)
+            c *= f.guadagno;
+        numeratore.insert(numeratore.begin(), n + 1 - numeratore.size(), 0.0);
+
+        // H(s) = D + N(s) / den(s) con N di grado < n
+        const double D = numeratore[0];
+        for (size_t i = 0; i <= n; i++)
+            numeratore[i] -= D * denominatore[i];
+        if (n == 0)
+        {
+            return coefficientiDa({D}, {1});
+        }
+
+        // Forma canonica di raggiungibilità, discretizzata con l'esponenziale della matrice aumentata
+        // [A B; 0 0] Tc -> [Ad Bd; 0 I]
+        Matrice aumentata(n + 1);
+        for (size_t i = 0; i + 1 < n; i++)
+            aumentata(i, i + 1) = Tc;
+        for (size_t j = 0; j < n; j++)
+            aumentata(n - 1, j) = -denominatore[n - j] * Tc;
+        aumentata(n - 1, n) = Tc;
+        Matrice esponenzialeAumentata = esponenziale(aumentata);
+
+        Matrice Ad(n), AdMenoBdC(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            for (size_t j = 0; j < n; j++)
+            {
+                Ad(i, j) = esponenzialeAumentata(i, j);
+                // C = [N_0 ... N_(n-1)] con N(s) = N_(n-1) s^(n-1) + ... + N_0
+                AdMenoBdC(i, j) = Ad(i, j) - esponenzialeAumentata(i, n) * numeratore[n - j];
+            }
+        }
+
+        // C (zI - Ad)^-1 Bd = (det(zI - Ad + Bd C) - det(zI - Ad)) / det(zI - Ad)
+        vector<double> denominatoreDiscreto = polinomioCaratteristico(Ad);
+        vector<double> numeratoreDiscreto = polinomioCaratteristico(AdMenoBdC);
+        for (size_t i = 0; i <= n; i++)
+            numeratoreDiscreto[i] += (D - 1) * denominatoreDiscreto[i];
+        return coefficientiDa(numeratoreDiscreto, denominatoreDiscreto);
+    }
+}
+
+CoefficientiRegolatore discretizza(const FunzioneTrasferimentoContinua &funzione, double tempoCampionamento,
+                                   MetodoDiscretizzazione metodo, double pulsazionePrewarp)
+{
+    if (tempoCampionamento <= 0)
+    {
+        throw invalid_argument("Discretizzazione: il periodo di campionamento deve essere positivo");
+    }
+    if (funzione.zeri.size() > funzione.poli.size())
+    {
+        throw invalid_argument("Discretizzazione: la funzione di trasferimento deve essere propria");
+    }
+
+    switch (metodo)
+    {
+    case DISCRETIZZAZIONE_TUSTIN:
+        return tustin(funzione, tempoCampionamento, pulsazionePrewarp);
+    case DISCRETIZZAZIONE_ZOH:
+        return zoh(funzione, tempoCampionamento);
+    case DISCRETIZZAZIONE_POLI_ZERI:
+        return poliZeri(funzione, tempoCampionamento);
+    }
+    throw invalid_argument("Discretizzazione: metodo non supportato");
+}
+
+FunzioneTrasferimentoContinua continuaDaTustin(const vector<double> &output_coeff, const vector<double> &input_coeff,
+                                               double tempoCampionamento)
+{
+    if (tempoCampionamento <= 0)
+    {
+        throw invalid_argument("Discretizzazione: il periodo di campionamento deve essere positivo");
+    }
+    const double k = 2 / tempoCampionamento;
+
+    // H(z) = (b0 + b1 z^-1 + ... + bn z^-n) / (1 - a1 z^-1 - ... - an z^-n)
+    vector<double> denominatore{1};
+    for (double a : output_coeff)
+    {
+        denominatore.push_back(-a);
+    }
+    vector<double> numeratore = input_coeff;
+    const size_t n = max(denominatore.size(), numeratore.size()) - 1;
+    denominatore.resize(n + 1, 0.0);
+    numeratore.resize(n + 1, 0.0);
+
+    // z = (k + s) / (k - s)  <=>  s = k (z - 1) / (z + 1); le radici in z = 0 aggiunte dal completamento
+    // al grado n diventano s = -k, i gradi mancanti del numeratore (zeri in z = infinito) diventano s = k
+    auto continua = [k](const vector<complex<double>> &radiciDiscrete, bool ammessoMenoUno)
+    {
+        vector<complex<double>> radici;
+        for (const complex<double> &r : radiciDiscrete)
+        {
+            if (abs(r + 1.0) < 1e-9)
+            {
+                if (!ammessoMenoUno)
+                {
+                    throw invalid_argument("Discretizzazione: un polo in z = -1 non ha equivalente tempo continuo");
+                }
+                continue;
+            }
+            radici.push_back(k * (r - 1.0) / (r + 1.0));
+        }
+        return radici;
+    };
+
+    FunzioneTrasferimentoContinua funzione;
+    funzione.poli = continua(radiciPolinomio(denominatore), false);
+    funzione.zeri = continua(radiciPolinomio(numeratore), true);
+    size_t zeriAllInfinito = 0;
+    while (zeriAllInfinito < numeratore.size() && numeratore[zeriAllInfinito] == 0)
+    {
+        zeriAllInfinito++;
+    }
+    if (zeriAllInfinito > n)
+    {
+        throw invalid_argument("Discretizzazione: il numeratore deve avere almeno un coefficiente non nullo");
+    }
+    funzione.zeri.insert(funzione.zeri.end(), zeriAllInfinito, k);
+    if (funzione.zeri.size() > funzione.poli.size())
+    {
+        throw invalid_argument("Discretizzazione: il regolatore tempo continuo equivalente non è proprio");
+    }
+
+    // Guadagno: H(s0) = H(z0) in un punto reale lontano da zeri e poli, con z0 = (k + s0) / (k - s0)
+    auto valuta = [](const vector<double> &polinomio, double x)
+    {
+        double valore = 0;
+        for (double c : polinomio)
+        {
+            valore = valore * x + c;
+        }
+        return valore;
+    };
+    double migliore = 0, guadagno = 0;
+    for (double z0 : {0.5, 0.3, 0.7, -0.5, 0.1, 0.9})
+    {
+        double s0 = k * (z0 - 1) / (z0 + 1);
+        complex<double> continua = 1;
+        for (const complex<double> &z : funzione.zeri)
+        {
+            continua *= s0 - z;
+        }
+        for (const complex<double> &p : funzione.poli)
+        {
+            continua /= s0 - p;
+        }
+        double discreta = valuta(numeratore, z0) / valuta(denominatore, z0);
+        double distanza = min(abs(continua), 1 / abs(continua));
+        if (isfinite(discreta) && distanza > migliore)
+        {
+            migliore = distanza;
+            guadagno = discreta / continua.real();
+        }
+    }
+    funzione.guadagno = guadagno;
+    return funzione;
+}
+
+FunzioneTrasferimentoContinua continuaDaPoliZeri(const vector<complex<double>> &zeri, const vector<complex<double>> &poli,
+                                                 double guadagno, double tempoCampionamento)
+{
+    if (tempoCampionamento <= 0)
+    {
+        throw invalid_argument("Discretizzazione: il periodo di campionamento deve essere positivo");
+    }
+    const double Tc = tempoCampionamento;
+
+    // Stesse corrispondenze di poliZeri() percorse al contrario: (1 - r z^-1) vale 1 - r in z = 1 e
+    // (s - ln(r) / Tc) vale -ln(r) / Tc in s = 0, le radici in z = 1 corrispondono a s / Tc
+    auto continua = [Tc](const complex<double> &r)
+    {
+        if (abs(r.imag()) < TOLLERANZA_IMMAGINARIA && r.real() <= 0)
+        {
+            throw invalid_argument("Discretizzazione: una radice reale non positiva non ha equivalente tempo continuo");
+        }
+        return log(r) / Tc;
+    };
+    FunzioneTrasferimentoContinua funzione;
+    complex<double> guadagnoContinuo = guadagno;
+    for (const complex<double> &z : zeri)
+    {
+        if (abs(z) < TOLLERANZA_ORIGINE)
+        {
+            continue;
+        }
+        funzione.zeri.push_back(continua(z));
+        guadagnoContinuo *= (abs(funzione.zeri.back()) < TOLLERANZA_ORIGINE) ? Tc : (1.0 - z) / -funzione.zeri.back();
+    }
+    for (const complex<double> &p : poli)
+    {
+        funzione.poli.push_back(continua(p));
+        guadagnoContinuo *= (abs(funzione.poli.back()) < TOLLERANZA_ORIGINE) ? 1 / Tc : -funzione.poli.back() / (1.0 - p);
+    }
+    if (funzione.zeri.size() > funzione.poli.size())
+    {
+        throw invalid_argument("Discretizzazione: il regolatore tempo continuo equivalente non è proprio");
+    }
+    funzione.guadagno = guadagnoContinuo.real();
+    return funzione;
+}
+
+Regolatore creaRegolatore(const FunzioneTrasferimentoContinua &funzione, double tempoCampionamento,
+                          MetodoDiscretizzazione metodo, double pulsazionePrewarp, Regolatore::Forma forma)
+{
+    CoefficientiRegolatore coefficienti = discretizza(funzione, tempoCampionamento, metodo, pulsazionePrewarp);
+    return Regolatore(coefficienti.output_coeff, coefficienti.input_coeff, forma);
+}
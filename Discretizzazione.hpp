@@ -0,0 +1,61 @@
+#ifndef DISCRETIZZAZIONE_HPP
+#define DISCRETIZZAZIONE_HPP
+
+#include <complex>
+#include <vector>
+#include <Regolatore.hpp>
+
+// Funzione di trasferimento tempo continuo in forma zeri-poli-guadagno:
+// H(s) = guadagno * (s - zeri[0]) ... (s - zeri[m-1]) / ((s - poli[0]) ... (s - poli[n-1]))
+// Zeri e poli complessi devono comparire in coppie coniugate, e deve essere m <= n.
+struct FunzioneTrasferimentoContinua
+{
+    std::vector<std::complex<double>> zeri; // rad/s
+    std::vector<std::complex<double>> poli; // rad/s
+    double guadagno;
+};
+
+enum MetodoDiscretizzazione
+{
+    // Bilineare s = k (z - 1) / (z + 1), con k = 2 / Tc oppure, se è data una pulsazione di prewarp w0,
+    // k = w0 / tan(w0 Tc / 2) così la risposta in frequenza coincide esattamente in w0.
+    // Gli zeri all'infinito vanno in z = -1.
+    DISCRETIZZAZIONE_TUSTIN,
+    // Equivalente esatto con ingresso mantenuto costante per un periodo (mantenitore di ordine zero)
+    DISCRETIZZAZIONE_ZOH,
+    // Poli e zeri corrispondenti z = e^(s Tc), guadagno uguale in continua. Gli zeri all'infinito vanno in z = 0:
+    // il regolatore ha numeratore e denominatore dello stesso grado e nessun ritardo aggiuntivo, come il
+    // progetto di setupRegulator(). Le singolarità nell'origine sono confrontate con (z - 1) / Tc.
+    DISCRETIZZAZIONE_POLI_ZERI
+};
+
+// Coefficienti nella convenzione di Regolatore: output_coeff sono i coefficienti di y[k - 1] ... y[k - n],
+// input_coeff quelli di u[k] ... u[k - n]
+struct CoefficientiRegolatore
+{
+    std::vector<double> output_coeff;
+    std::vector<double> input_coeff;
+};
+
+// Discretizza H(s) con il periodo di campionamento indicato (in secondi).
+// pulsazionePrewarp (rad/s) è usata solo da DISCRETIZZAZIONE_TUSTIN, 0 per la bilineare semplice.
+CoefficientiRegolatore discretizza(const FunzioneTrasferimentoContinua &funzione, double tempoCampionamento,
+                                   MetodoDiscretizzazione metodo, double pulsazionePrewarp = 0);
+
+// Inversa della bilineare semplice (k = 2 / Tc): H(s) tale che discretizza(H, Tc, DISCRETIZZAZIONE_TUSTIN)
+// restituisca i coefficienti dati. Gli zeri in z = -1 diventano zeri all'infinito, i poli in z = -1 non sono ammessi.
+FunzioneTrasferimentoContinua continuaDaTustin(const std::vector<double> &output_coeff, const std::vector<double> &input_coeff,
+                                               double tempoCampionamento);
+
+// Inversa di DISCRETIZZAZIONE_POLI_ZERI per H(z) = guadagno (1 - zeri[0] z^-1) ... / ((1 - poli[0] z^-1) ...):
+// s = ln(z) / Tc e stesso guadagno in continua. Gli zeri in z = 0 diventano zeri all'infinito, le radici reali
+// negative non hanno equivalente tempo continuo.
+FunzioneTrasferimentoContinua continuaDaPoliZeri(const std::vector<std::complex<double>> &zeri, const std::vector<std::complex<double>> &poli,
+                                                 double guadagno, double tempoCampionamento);
+
+// Regolatore pronto per il ciclo di controllo ottenuto discretizzando H(s)
+Regolatore creaRegolatore(const FunzioneTrasferimentoContinua &funzione, double tempoCampionamento,
+                          MetodoDiscretizzazione metodo, double pulsazionePrewarp = 0,
+                          Regolatore::Forma forma = Regolatore::FORMA_SEZIONI);
+
+#endif
@@ -0,0 +1,112 @@
+#include <EsecutorePeriodico.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <stdexcept>
+#include <time.h>
+
+using namespace std;
+
+#define NS_PER_SECONDO 1000000000LL
+
+EsecutorePeriodico::EsecutorePeriodico(double periodo, const ParametriEsecutore &parametri)
+    : periodo(llround(periodo * NS_PER_SECONDO)), parametri(parametri)
+{
+    if (this->periodo <= 0 || !(parametri.ampiezzaClasse > 0) || parametri.classi == 0)
+    {
+        throw invalid_argument("EsecutorePeriodico: parametri non validi");
+    }
+    istogrammaLatenza.assign(parametri.classi + 1, 0);
+    istogrammaSforamento.assign(parametri.classi + 1, 0);
+}
+
+int64_t EsecutorePeriodico::adesso()
+{
+    timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * NS_PER_SECONDO + t.tv_nsec;
+}
+
+void EsecutorePeriodico::avvia()
+{
+    inizio = adesso();
+    scadenza = 0;
+}
+
+void EsecutorePeriodico::registra(vector<size_t> &istogramma, int64_t valore)
+{
+    size_t classe = (size_t)(max<int64_t>(0, valore) / (parametri.ampiezzaClasse * NS_PER_SECONDO));
+    istogramma[min(classe, parametri.classi)]++;
+}
+
+bool EsecutorePeriodico::attendi()
+{
+    campioni++;
+    int64_t fine = adesso();
+    int64_t prossima = inizio + (int64_t)(scadenza + 1) * periodo;
+    if (fine > prossima)
+    {
+        // Campione finito dopo la scadenza successiva
+        ritardi++;
+        sforamentoMassimo = max(sforamentoMassimo, fine - prossima);
+        registra(istogrammaSforamento, fine - prossima);
+        if (parametri.politica == RITARDO_INTERROMPI)
+        {
+            return false;
+        }
+        if (parametri.politica == RITARDO_RECUPERA)
+        {
+            // Nessuna attesa: il prossimo campione parte subito, la griglia delle scadenze resta quella
+            scadenza++;
+            return true;
+        }
+        // Prima scadenza futura, sulla stessa griglia
+        uint64_t successiva = (uint64_t)((fine - inizio) / periodo) + 1;
+        saltati += successiva - scadenza - 1;
+        scadenza = successiva - 1;
+        prossima = inizio + (int64_t)successiva * periodo;
+    }
+    scadenza++;
+
+    timespec t;
+    t.tv_sec = prossima / NS_PER_SECONDO;
+    t.tv_nsec = prossima % NS_PER_SECONDO;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &t, nullptr) == EINTR)
+    {
+        // Segnale durante l'attesa: la scadenza assoluta non cambia
+    }
+    int64_t latenza = adesso() - prossima;
+    latenzaMassima = max(latenzaMassima, latenza);
+    registra(istogrammaLatenza, latenza);
+    return true;
+}
+
+void EsecutorePeriodico::stampaIstogramma(ostream &out, const vector<size_t> &istogramma) const
+{
+    const double ampiezza = parametri.ampiezzaClasse * 1e6;
+    for (size_t i = 0; i < istogramma.size(); i++)
+    {
+        if (istogramma[i] == 0)
+        {
+            continue;
+        }
+        if (i == parametri.classi)
+            out << "    oltre " << i * ampiezza << " us: " << istogramma[i] << endl;
+        else
+            out << "    " << i * ampiezza << " - " << (i + 1) * ampiezza << " us: " << istogramma[i] << endl;
+    }
+}
+
+void EsecutorePeriodico::stampa(ostream &out) const
+{
+    const char *politiche[] = {"salta", "recupera", "interrompi"};
+    out << "Esecutore periodico (periodo " << periodo * 1e-3 << " us, politica " << politiche[parametri.politica] << ") su "
+        << campioni << " campioni: in ritardo " << ritardi << ", scadenze saltate " << saltati << endl;
+    out << "  Latenza di risveglio (max " << latenzaMassima * 1e-3 << " us):" << endl;
+    stampaIstogramma(out, istogrammaLatenza);
+    if (ritardi > 0)
+    {
+        out << "  Sforamento della scadenza successiva (max " << sforamentoMassimo * 1e-3 << " us):" << endl;
+        stampaIstogramma(out, istogrammaSforamento);
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef ESECUTORE_PERIODICO_HPP
+#define ESECUTORE_PERIODICO_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// Comportamento quando un campione finisce dopo la scadenza del successivo
+enum PoliticaRitardo
+{
+    RITARDO_SALTA,     // le scadenze perse sono saltate: si riparte dalla prima futura, sempre sulla griglia dei periodi
+    RITARDO_RECUPERA,  // i campioni in ritardo sono eseguiti uno dopo l'altro senza attesa finché non si torna in pari
+    RITARDO_INTERROMPI // attendi() ritorna false: il chiamante ferma il ciclo
+};
+
+// Parametri dell'esecutore e degli istogrammi
+struct ParametriEsecutore
+{
+    PoliticaRitardo politica = RITARDO_SALTA;
+    double ampiezzaClasse = 50e-6; // s, larghezza di una classe degli istogrammi
+    std::size_t classi = 40;       // classi degli istogrammi, più una per i valori oltre l'ultima
+};
+
+/*
+    Esecuzione periodica a scadenze assolute su CLOCK_MONOTONIC.
+
+    Le scadenze sono inizio + k periodo, con l'inizio fissato da avvia(): attendi() dorme con
+    clock_nanosleep(TIMER_ABSTIME) fino alla prossima, quindi il periodo medio non deriva con la durata del
+    campione né con la latenza di risveglio, e i salti dell'orologio di sistema non hanno effetto.
+
+    Per ogni campione sono raccolti due istogrammi:
+    - latenza di risveglio: ritardo tra la scadenza e il ritorno da clock_nanosleep (jitter del periodo);
+    - sforamento: di quanto il campione è finito dopo la scadenza successiva (solo campioni in ritardo).
+    Gli istogrammi sono allocati nel costruttore: attendi() non alloca.
+*/
+class EsecutorePeriodico
+{
+private:
+    int64_t periodo; // ns
+    ParametriEsecutore parametri;
+    int64_t inizio = 0;    // ns, istante della scadenza 0
+    uint64_t scadenza = 0; // indice della scadenza del campione in corso
+    std::size_t campioni = 0, ritardi = 0, saltati = 0;
+    int64_t latenzaMassima = 0, sforamentoMassimo = 0;
+    std::vector<std::size_t> istogrammaLatenza, istogrammaSforamento;
+
+    void registra(std::vector<std::size_t> &istogramma, int64_t valore);
+    void stampaIstogramma(std::ostream &out, const std::vector<std::size_t> &istogramma) const;
+
+public:
+    EsecutorePeriodico(double periodo, const ParametriEsecutore &parametri = ParametriEsecutore());
+
+    // Istante attuale in ns su CLOCK_MONOTONIC
+    static int64_t adesso();
+
+    // Il campione in corso è la scadenza 0; da chiamare all'inizio e alla ripresa dopo una pausa
+    void avvia();
+
+    // Fine del campione: attende la scadenza successiva secondo la politica. False solo con RITARDO_INTERROMPI
+    // e il campione in ritardo (nessuna attesa)
+    bool attendi();
+
+    std::size_t getCampioni() const { return campioni; }
+    std::size_t getRitardi() const { return ritardi; } // campioni finiti dopo la scadenza successiva
+    std::size_t getSaltati() const { return saltati; } // scadenze saltate con RITARDO_SALTA
+    // s, istante nominale (scadenza) del campione in corso dall'ultimo avvia(), scadenze saltate comprese
+    double getTempo() const { return scadenza * (periodo * 1e-9); }
+
+    // Riepilogo e istogrammi in microsecondi
+    void stampa(std::ostream &out) const;
+};
+
+#endif
@@ -0,0 +1,148 @@
+#include <EsperimentoRele.hpp>
+#include <Polinomi.hpp>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+EsperimentoRele::EsperimentoRele(const ParametriRele &parametri)
+    : parametri(parametri)
+{
+    if (!(parametri.ampiezza > 0) || parametri.isteresi < 0 || parametri.periodiMisurati == 0 || !(parametri.durataMassima > 0))
+    {
+        throw invalid_argument("EsperimentoRele: parametri non validi");
+    }
+}
+
+float EsperimentoRele::uscita(float errore, float periodo)
+{
+    if (stato != IN_CORSO)
+    {
+        return 0;
+    }
+    tempo += periodo;
+    if (tempo > parametri.durataMassima)
+    {
+        stato = FALLITO;
+        return 0;
+    }
+
+    // Primo campione: il relè parte dal verso che riduce l'errore
+    if (uscitaAttuale == 0)
+    {
+        uscitaAttuale = (errore >= 0) ? parametri.ampiezza : -parametri.ampiezza;
+        erroreMassimo = erroreMinimo = errore;
+        errorePrecedente = errore;
+        return uscitaAttuale;
+    }
+
+    erroreMassimo = max(erroreMassimo, (double)errore);
+    erroreMinimo = min(erroreMinimo, (double)errore);
+
+    if (uscitaAttuale < 0 && errore > parametri.isteresi)
+    {
+        // Istante in cui l'errore ha attraversato la soglia, interpolato nel periodo appena trascorso
+        double frazione = (errore - parametri.isteresi) / (errore - errorePrecedente);
+        double salita = tempo - min(1.0, max(0.0, frazione)) * periodo;
+        if (ultimaSalita >= 0)
+        {
+            // Un periodo completo tra due salite: estremi raccolti dall'ultima salita
+            periodiCompletati++;
+            if (periodiCompletati > parametri.periodiScartati)
+            {
+                sommaPeriodi += salita - ultimaSalita;
+                sommaAmpiezze += (erroreMassimo - erroreMinimo) / 2;
+            }
+            if (periodiCompletati >= parametri.periodiScartati + parametri.periodiMisurati)
+            {
+                stato = (sommaAmpiezze / parametri.periodiMisurati > parametri.isteresi) ? COMPLETATO : FALLITO;
+                return 0;
+            }
+        }
+        ultimaSalita = salita;
+        erroreMassimo = erroreMinimo = errore;
+        uscitaAttuale = parametri.ampiezza;
+    }
+    else if (uscitaAttuale > 0 && errore < -parametri.isteresi)
+    {
+        uscitaAttuale = -parametri.ampiezza;
+    }
+    errorePrecedente = errore;
+    return uscitaAttuale;
+}
+
+void EsperimentoRele::reset()
+{
+    stato = IN_CORSO;
+    uscitaAttuale = 0;
+    tempo = 0;
+    erroreMassimo = erroreMinimo = 0;
+    ultimaSalita = -1;
+    periodiCompletati = 0;
+    sommaPeriodi = sommaAmpiezze = 0;
+    errorePrecedente = 0;
+}
+
+RisultatoRele EsperimentoRele::getRisultato() const
+{
+    RisultatoRele risultato;
+    risultato.ampiezza = sommaAmpiezze / parametri.periodiMisurati;
+    risultato.periodo = sommaPeriodi / parametri.periodiMisurati;
+    const double a = risultato.ampiezza, e = parametri.isteresi;
+    risultato.guadagnoCritico = 4 * parametri.ampiezza / (M_PI * sqrt(a * a - e * e));
+    risultato.periodoCritico = risultato.periodo;
+    return risultato;
+}
+
+FunzioneTrasferimentoContinua taraturaRele(const RisultatoRele &risultato, RegolaTaratura regola, double N)
+{
+    const double Ku = risultato.guadagnoCritico, Tu = risultato.periodoCritico;
+    if (!(Ku > 0) || !(Tu > 0) || !(N > 0))
+    {
+        throw invalid_argument("taraturaRele: punto critico non valido");
+    }
+
+    FunzioneTrasferimentoContinua funzione;
+    if (regola == TARATURA_PD)
+    {
+        // Kp (1 + Td s) / (1 + Td s / N) = Kp N (s + 1 / Td) / (s + N / Td)
+        const double Kp = 0.8 * Ku, Td = Tu / 8;
+        funzione.zeri = {-1 / Td};
+        funzione.poli = {-N / Td};
+        funzione.guadagno = Kp * N;
+        return funzione;
+    }
+
+    double Kp, Ti, Td;
+    if (regola == TARATURA_PID)
+    {
+        Kp = 0.2 * Ku;
+        Ti = Tu / 2;
+        Td = Tu / 3;
+    }
+    else
+    {
+        Kp = Ku / 2.2;
+        Ti = 2.2 * Tu;
+        Td = Tu / 6.3;
+    }
+    // Kp (1 + 1 / (Ti s) + Td s / (1 + Td s / N)):
+    // numeratore Ti Td (1 + 1 / N) s^2 + (Ti + Td / N) s + 1, denominatore Ti (Td / N) s (s + N / Td)
+    funzione.zeri = radiciPolinomio({Ti * Td * (1 + 1 / N), Ti + Td / N, 1});
+    funzione.poli = {0, -N / Td};
+    funzione.guadagno = Kp * (N + 1);
+    return funzione;
+}
+
+bool regolaDaNome(const string &nome, RegolaTaratura &regola)
+{
+    if (nome == "pd")
+        regola = TARATURA_PD;
+    else if (nome == "pid")
+        regola = TARATURA_PID;
+    else if (nome == "tl")
+        regola = TARATURA_TYREUS_LUYBEN;
+    else
+        return false;
+    return true;
+}
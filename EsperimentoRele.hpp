@@ -0,0 +1,90 @@
+#ifndef ESPERIMENTO_RELE_HPP
+#define ESPERIMENTO_RELE_HPP
+
+#include <cstddef>
+#include <string>
+#include <Discretizzazione.hpp>
+
+// Parametri dell'esperimento: con il modello del Meca500 il ciclo limite ha un'ampiezza di circa 10 mm
+// e un periodo di circa 0.7 s, quindi l'esperimento dura pochi secondi
+struct ParametriRele
+{
+    double ampiezza = 100;          // mm/s, velocità comandata in ciascuno dei due stati del relè
+    double isteresi = 2;            // mm, soglia sull'errore per la commutazione (oltre rumore e quantizzazione del sensore)
+    std::size_t periodiScartati = 2; // periodi iniziali ignorati mentre il ciclo limite si assesta
+    std::size_t periodiMisurati = 4; // periodi mediati per ampiezza e periodo
+    double durataMassima = 15;      // s, oltre i quali l'esperimento fallisce
+};
+
+// Ciclo limite misurato e punto critico equivalente dell'anello
+struct RisultatoRele
+{
+    double ampiezza;        // mm, metà dell'oscillazione picco-picco dell'errore
+    double periodo;         // s, periodo del ciclo limite
+    double guadagnoCritico; // (mm/s)/mm, Ku = 4 d / (pi sqrt(a^2 - isteresi^2))
+    double periodoCritico;  // s, Tu = periodo
+};
+
+// Regole di taratura dal punto critico, con il derivativo filtrato a Td / N
+enum RegolaTaratura
+{
+    TARATURA_PD,             // Ziegler-Nichols PD: Kp = 0.8 Ku, Td = Tu / 8 (l'impianto ha già l'integratore)
+    TARATURA_PID,            // Ziegler-Nichols PID "no overshoot": Kp = 0.2 Ku, Ti = Tu / 2, Td = Tu / 3
+    TARATURA_TYREUS_LUYBEN   // Tyreus-Luyben PID: Kp = Ku / 2.2, Ti = 2.2 Tu, Td = Tu / 6.3
+};
+
+/*
+    Esperimento a relè con isteresi (Astrom-Hagglund) per la taratura in linea del regolatore della distanza.
+
+    Al posto del regolatore il ciclo di controllo comanda +ampiezza quando l'errore supera l'isteresi e
+    -ampiezza quando scende sotto -isteresi: l'anello entra in un ciclo limite attorno al riferimento attuale
+    alla pulsazione in cui la fase dell'anello è -180 gradi. L'approssimazione della prima armonica dà il
+    guadagno critico Ku = 4 d / (pi sqrt(a^2 - e^2)) (d ampiezza del relè, a dell'errore, e isteresi) e il
+    periodo critico Tu, da cui le regole di taratura classiche.
+
+    Gli istanti di commutazione sono interpolati linearmente tra i campioni, con il periodo misurato di ogni
+    campione: il periodo del ciclo limite non è quantizzato a Tc. uscita() non alloca e può stare nel ciclo
+    di controllo; la taratura e la discretizzazione vanno fatte fuori, a esperimento concluso.
+*/
+class EsperimentoRele
+{
+public:
+    enum Stato
+    {
+        IN_CORSO,
+        COMPLETATO,
+        FALLITO
+    };
+
+private:
+    ParametriRele parametri;
+    Stato stato = IN_CORSO;
+    float uscitaAttuale = 0;
+    double tempo = 0;
+    double erroreMassimo = 0, erroreMinimo = 0; // estremi del periodo in corso
+    double ultimaSalita = -1;                   // istante dell'ultima commutazione verso +ampiezza
+    std::size_t periodiCompletati = 0;
+    double sommaPeriodi = 0, sommaAmpiezze = 0;
+    double errorePrecedente = 0;
+
+public:
+    explicit EsperimentoRele(const ParametriRele &parametri = ParametriRele());
+
+    // Velocità da comandare con l'errore attuale e il periodo trascorso dal campione precedente (s)
+    float uscita(float errore, float periodo);
+
+    // Nuovo esperimento dal campione successivo
+    void reset();
+
+    Stato getStato() const { return stato; }
+    // Valido solo con lo stato COMPLETATO
+    RisultatoRele getRisultato() const;
+};
+
+// Regolatore tempo continuo per la regola indicata (N: rapporto del filtro sul derivativo)
+FunzioneTrasferimentoContinua taraturaRele(const RisultatoRele &risultato, RegolaTaratura regola, double N = 10);
+
+// "pd", "pid", "tl"; false se il nome non corrisponde a nessuna regola
+bool regolaDaNome(const std::string &nome, RegolaTaratura &regola);
+
+#endif
@@ -0,0 +1,77 @@
+#include <GruppiGraffe.hpp>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+using namespace std;
+
+namespace
+{
+    void saltaSpazi(const string &testo, size_t &posizione)
+    {
+        while (posizione < testo.size() && isspace((unsigned char)testo[posizione]))
+        {
+            posizione++;
+        }
+    }
+
+    [[noreturn]] void formatoNonValido(const string &testo, size_t posizione, const string &atteso)
+    {
+        throw invalid_argument("gruppiGraffe: atteso " + atteso + " in posizione " + to_string(posizione) + " di \"" + testo + "\"");
+    }
+}
+
+vector<vector<double>> gruppiGraffe(const string &testo)
+{
+    vector<vector<double>> gruppi;
+    size_t posizione = 0;
+    saltaSpazi(testo, posizione);
+    while (posizione < testo.size())
+    {
+        if (testo[posizione] != '{')
+        {
+            formatoNonValido(testo, posizione, "'{'");
+        }
+        posizione++;
+        saltaSpazi(testo, posizione);
+
+        vector<double> gruppo;
+        if (posizione < testo.size() && testo[posizione] == '}')
+        {
+            posizione++;
+        }
+        else
+        {
+            // Numero, poi ',' seguita da un altro numero oppure '}'
+            while (true)
+            {
+                const char *inizio = testo.c_str() + posizione;
+                char *fine;
+                double valore = strtod(inizio, &fine);
+                if (fine == inizio || !isfinite(valore))
+                {
+                    formatoNonValido(testo, posizione, "un numero");
+                }
+                gruppo.push_back(valore);
+                posizione += fine - inizio;
+                saltaSpazi(testo, posizione);
+                if (posizione < testo.size() && testo[posizione] == ',')
+                {
+                    posizione++;
+                    saltaSpazi(testo, posizione);
+                    continue;
+                }
+                if (posizione < testo.size() && testo[posizione] == '}')
+                {
+                    posizione++;
+                    break;
+                }
+                formatoNonValido(testo, posizione, "',' o '}'");
+            }
+        }
+        gruppi.push_back(gruppo);
+        saltaSpazi(testo, posizione);
+    }
+    return gruppi;
+}
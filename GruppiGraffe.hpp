@@ -0,0 +1,13 @@
+#ifndef GRUPPI_GRAFFE_HPP
+#define GRUPPI_GRAFFE_HPP
+
+#include <string>
+#include <vector>
+
+// Gruppi di numeri tra graffe separati da virgole, spazi ammessi attorno a numeri e graffe: "{1, 2} {3}" ->
+// {{1, 2}, {3}}, "{}" è un gruppo vuoto. Formato dei coefficienti {b0, b1, ...}{a1, a2, ...} usato da --reg,
+// --margins e montecarlo. Lancia invalid_argument se il testo non è tutto in questo formato
+// (testo fuori dalle graffe, numero non valido o non finito, separatore diverso dalla virgola, gruppo non chiuso).
+std::vector<std::vector<double>> gruppiGraffe(const std::string &testo);
+
+#endif
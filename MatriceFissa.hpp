@@ -0,0 +1,92 @@
+#ifndef MATRICE_FISSA_HPP
+#define MATRICE_FISSA_HPP
+
+#include <array>
+#include <cstddef>
+
+// Matrice di dimensione fissata a tempo di compilazione, memorizzata per righe in uno std::array:
+// le operazioni non allocano e i cicli, di lunghezza nota, vengono srotolati dal compilatore.
+// Le dimensioni incompatibili sono errori di compilazione.
+template <std::size_t Righe, std::size_t Colonne>
+struct MatriceFissa
+{
+    std::array<double, Righe * Colonne> dati{};
+
+    double &operator()(std::size_t i, std::size_t j) { return dati[i * Colonne + j]; }
+    double operator()(std::size_t i, std::size_t j) const { return dati[i * Colonne + j]; }
+
+    static MatriceFissa identita()
+    {
+        static_assert(Righe == Colonne, "MatriceFissa: l'identita' e' quadrata");
+        MatriceFissa risultato;
+        for (std::size_t i = 0; i < Righe; i++)
+        {
+            risultato(i, i) = 1;
+        }
+        return risultato;
+    }
+
+    MatriceFissa<Colonne, Righe> trasposta() const
+    {
+        MatriceFissa<Colonne, Righe> risultato;
+        for (std::size_t i = 0; i < Righe; i++)
+        {
+            for (std::size_t j = 0; j < Colonne; j++)
+            {
+                risultato(j, i) = (*this)(i, j);
+            }
+        }
+        return risultato;
+    }
+
+    MatriceFissa operator+(const MatriceFissa &altra) const
+    {
+        MatriceFissa risultato;
+        for (std::size_t i = 0; i < Righe * Colonne; i++)
+        {
+            risultato.dati[i] = dati[i] + altra.dati[i];
+        }
+        return risultato;
+    }
+
+    MatriceFissa operator-(const MatriceFissa &altra) const
+    {
+        MatriceFissa risultato;
+        for (std::size_t i = 0; i < Righe * Colonne; i++)
+        {
+            risultato.dati[i] = dati[i] - altra.dati[i];
+        }
+        return risultato;
+    }
+
+    MatriceFissa operator*(double scalare) const
+    {
+        MatriceFissa risultato;
+        for (std::size_t i = 0; i < Righe * Colonne; i++)
+        {
+            risultato.dati[i] = dati[i] * scalare;
+        }
+        return risultato;
+    }
+
+    template <std::size_t ColonneAltra>
+    MatriceFissa<Righe, ColonneAltra> operator*(const MatriceFissa<Colonne, ColonneAltra> &altra) const
+    {
+        MatriceFissa<Righe, ColonneAltra> risultato;
+        for (std::size_t i = 0; i < Righe; i++)
+        {
+            for (std::size_t j = 0; j < ColonneAltra; j++)
+            {
+                double somma = 0;
+                for (std::size_t k = 0; k < Colonne; k++)
+                {
+                    somma += (*this)(i, k) * altra(k, j);
+                }
+                risultato(i, j) = somma;
+            }
+        }
+        return risultato;
+    }
+};
+
+#endif
@@ -0,0 +1,86 @@
+#include <ModelloMeca500.hpp>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+ModelloMeca500::ModelloMeca500(const ParametriMeca500 &parametri, double tempoCampionamento, double posizioneIniziale)
+    : parametri(parametri), tempoCampionamento(tempoCampionamento), posizione(posizioneIniziale)
+{
+    if (tempoCampionamento <= 0 || parametri.costanteTempo <= 0)
+    {
+        throw invalid_argument("ModelloMeca500: parametri non validi");
+    }
+    setRitardo(parametri.ritardo);
+}
+
+void ModelloMeca500::setRitardo(double ritardo)
+{
+    if (!(ritardo >= 0))
+    {
+        throw invalid_argument("ModelloMeca500: parametri non validi");
+    }
+    size_t campioni = (size_t)floor(ritardo / tempoCampionamento);
+    if (campioni > MAX_RITARDO_CAMPIONI)
+    {
+        throw invalid_argument("ModelloMeca500: ritardo troppo lungo rispetto al periodo di campionamento");
+    }
+    parametri.ritardo = ritardo;
+    ritardoCampioni = campioni;
+    frazioneRitardo = ritardo - ritardoCampioni * tempoCampionamento;
+
+    // Costanti dei due tratti di ogni periodo: [0, f) con il comando più vecchio, [f, Tc) con il successivo
+    double T = parametri.costanteTempo;
+    decadimentoPrimoTratto = exp(-frazioneRitardo / T);
+    decadimentoSecondoTratto = exp(-(tempoCampionamento - frazioneRitardo) / T);
+    integralePrimoTratto = T * (1 - decadimentoPrimoTratto);
+    integraleSecondoTratto = T * (1 - decadimentoSecondoTratto);
+}
+
+void ModelloMeca500::tratto(double ingresso, double durata, double decadimento, double integrale)
+{
+    // v(t) = u + (v0 - u) e^(-t/T), x(t) = x0 + u t + (v0 - u) T (1 - e^(-t/T))
+    posizione += ingresso * durata + (velocita - ingresso) * integrale;
+    velocita = ingresso + (velocita - ingresso) * decadimento;
+}
+
+void ModelloMeca500::passo(double velocitaComandata)
+{
+    velocitaComandata = clamp(velocitaComandata, -parametri.velocitaMassima, parametri.velocitaMassima);
+
+    // Coda circolare dei comandi: comandi[indice] è u[k], il comando u[k - j] è j posizioni più avanti
+    const size_t dimensione = comandi.size();
+    indiceComando = (indiceComando == 0) ? dimensione - 1 : indiceComando - 1;
+    comandi[indiceComando] = parametri.guadagno * velocitaComandata;
+
+    double comandoPrecedente = comandi[(indiceComando + ritardoCampioni + 1) % dimensione]; // u[k - d - 1]
+    double comandoAttuale = comandi[(indiceComando + ritardoCampioni) % dimensione];         // u[k - d]
+
+    tratto(comandoPrecedente, frazioneRitardo, decadimentoPrimoTratto, integralePrimoTratto);
+    tratto(comandoAttuale, tempoCampionamento - frazioneRitardo, decadimentoSecondoTratto, integraleSecondoTratto);
+}
+
+void ModelloMeca500::reset(double posizioneIniziale, double velocitaComandata)
+{
+    velocitaComandata = clamp(velocitaComandata, -parametri.velocitaMassima, parametri.velocitaMassima);
+    comandi.fill(parametri.guadagno * velocitaComandata);
+    indiceComando = 0;
+    posizione = posizioneIniziale;
+    velocita = parametri.guadagno * velocitaComandata;
+}
+
+complex<double> ModelloMeca500::rispostaInFrequenza(double pulsazione) const
+{
+    // Dalle equazioni di passo() con u[k - d - 1] = z^-(d+1) U e u[k - d] = z^-d U:
+    // (z - D1 D2) V = (D2 (1 - D1) z^-1 + 1 - D2) z^-d K U
+    // (z - 1) X = (I1 + I2 D1) V + ((f - I1 + I2 (1 - D1)) z^-1 + Tc - f - I2) z^-d K U
+    const double D1 = decadimentoPrimoTratto, D2 = decadimentoSecondoTratto;
+    const double I1 = integralePrimoTratto, I2 = integraleSecondoTratto;
+    const double f = frazioneRitardo, Tc = tempoCampionamento;
+    const complex<double> z = polar(1.0, pulsazione * Tc);
+    const complex<double> zInv = conj(z);
+    const complex<double> ingresso = parametri.guadagno * pow(zInv, (int)ritardoCampioni);
+    const complex<double> velocita = (D2 * (1 - D1) * zInv + (1 - D2)) * ingresso / (z - D1 * D2);
+    return ((I1 + I2 * D1) * velocita + ((f - I1 + I2 * (1 - D1)) * zInv + (Tc - f - I2)) * ingresso) / (z - 1.0);
+}
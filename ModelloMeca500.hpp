@@ -0,0 +1,73 @@
+#ifndef MODELLO_MECA500_HPP
+#define MODELLO_MECA500_HPP
+
+#include <array>
+#include <complex>
+#include <cstddef>
+
+// Numero massimo di campioni di ritardo rappresentabili dal modello
+#define MAX_RITARDO_CAMPIONI 64
+
+// Parametri del modello di velocità del Meca500 identificato con find_tf.py (risposta al gradino di
+// robot_test_data/test_velocity_input_*): G(s) = guadagno * e^(-ritardo s) / (1 + costanteTempo s)
+struct ParametriMeca500
+{
+    double costanteTempo = 0.117; // T in secondi
+    double ritardo = 0.072;       // Tau in secondi
+    double guadagno = 1.0;        // la velocità a regime coincide con quella comandata
+    double velocitaMassima = 1000; // velocità cartesiana massima accettata dal Meca500 in mm/s
+};
+
+/*
+    Modello tempo discreto della posizione x del Meca500 comandato in velocità con moveLinVelWRF.
+
+    La velocità comandata è mantenuta costante per un periodo di campionamento (ZOH) e la discretizzazione
+    è esatta anche per ritardi non multipli del periodo: il ritardo è scomposto in d periodi interi più una
+    frazione f, così in ogni periodo l'ingresso effettivo cambia una sola volta all'istante f. Anche la
+    posizione è ottenuta integrando esattamente la risposta del primo ordine su ciascun tratto.
+*/
+class ModelloMeca500
+{
+private:
+    ParametriMeca500 parametri;
+    double tempoCampionamento;
+    std::size_t ritardoCampioni; // d
+    double frazioneRitardo;       // f
+    double decadimentoPrimoTratto, decadimentoSecondoTratto;
+    double integralePrimoTratto, integraleSecondoTratto;
+
+    std::array<double, MAX_RITARDO_CAMPIONI + 2> comandi{};
+    std::size_t indiceComando = 0;
+
+    double posizione;
+    double velocita = 0;
+
+    // Evoluzione esatta per una durata con ingresso costante
+    void tratto(double ingresso, double durata, double decadimento, double integrale);
+
+public:
+    ModelloMeca500(const ParametriMeca500 &parametri, double tempoCampionamento, double posizioneIniziale);
+
+    // Applica la velocità comandata all'istante attuale e fa evolvere il modello di un periodo
+    void passo(double velocitaComandata);
+
+    // Riporta il robot nella posizione indicata a regime con la velocità comandata indicata (fermo di default),
+    // con lo stesso comando in coda per tutto il ritardo
+    void reset(double posizioneIniziale, double velocitaComandata = 0);
+
+    // Nuovo ritardo (s) mantenendo stato e comandi in coda: i comandi già inviati arrivano al robot con il
+    // nuovo ritardo, senza salti di posizione o velocità
+    void setRitardo(double ritardo);
+
+    // Sposta la posizione mantenendo velocità e comandi in coda (correzione con la posizione misurata)
+    void setPosizione(double nuovaPosizione) { posizione = nuovaPosizione; }
+
+    // Risposta in frequenza esatta G(e^(j w Tc)) dalla velocità comandata alla posizione (w in rad/s, w > 0),
+    // con lo stesso mantenitore e lo stesso ritardo frazionario di passo()
+    std::complex<double> rispostaInFrequenza(double pulsazione) const;
+
+    double getPosizione() const { return posizione; }
+    double getVelocita() const { return velocita; }
+};
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef MODELLO_SENSORE_IR_HPP
+#define MODELLO_SENSORE_IR_HPP
+
+#include <cmath>
+#include <cstdint>
+
+// Parametri del modello del sensore infrarosso: InfraredSensor::getDistanceInMillimeters restituisce
+// millimetri interi, con un rumore di qualche millimetro e un valore fisso quando l'ostacolo è fuori portata
+struct ParametriSensoreIR
+{
+    double deviazioneStandard = 1.0;  // rumore gaussiano in mm
+    double quantizzazione = 1.0;      // risoluzione in mm (0 per disabilitare)
+    double portata = 200;             // distanza massima misurabile in mm
+    double valoreFuoriPortata = 255;  // valore restituito oltre la portata
+    uint64_t seme = 0x9E3779B97F4A7C15ull;
+};
+
+// Modello del sensore: rumore gaussiano (xorshift64* e Box-Muller), quantizzazione e saturazione alla portata
+class ModelloSensoreIR
+{
+private:
+    ParametriSensoreIR parametri;
+    uint64_t stato;
+    double gaussianaSalvata = 0;
+    bool gaussianaDisponibile = false;
+
+    double uniforme()
+    {
+        stato ^= stato >> 12;
+        stato ^= stato << 25;
+        stato ^= stato >> 27;
+        return ((stato * 0x2545F4914F6CDD1Dull) >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    double gaussiana()
+    {
+        if (gaussianaDisponibile)
+        {
+            gaussianaDisponibile = false;
+            return gaussianaSalvata;
+        }
+        double u1 = uniforme(), u2 = uniforme();
+        double raggio = std::sqrt(-2.0 * std::log(u1 + 1e-300));
+        gaussianaSalvata = raggio * std::sin(2 * M_PI * u2);
+        gaussianaDisponibile = true;
+        return raggio * std::cos(2 * M_PI * u2);
+    }
+
+public:
+    explicit ModelloSensoreIR(const ParametriSensoreIR &parametri = ParametriSensoreIR())
+        : parametri(parametri), stato(parametri.seme ? parametri.seme : 1) {}
+
+    // Distanza misurata in mm (positiva, come InfraredSensor::getDistanceInMillimeters)
+    double misura(double distanzaVera)
+    {
+        if (distanzaVera > parametri.portata)
+        {
+            return parametri.valoreFuoriPortata;
+        }
+        double misura = distanzaVera;
+        if (parametri.deviazioneStandard > 0)
+        {
+            misura += parametri.deviazioneStandard * gaussiana();
+        }
+        if (parametri.quantizzazione > 0)
+        {
+            misura = std::round(misura / parametri.quantizzazione) * parametri.quantizzazione;
+        }
+        return misura;
+    }
+};
+
+#endif
@@ -0,0 +1,57 @@
+#include <OsservatoreDisturbo.hpp>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+OsservatoreDisturbo::OsservatoreDisturbo(const ParametriMeca500 &impianto, double tempoCampionamento, const ParametriOsservatoreDisturbo &parametri)
+    : parametri(parametri), impianto(impianto), modello(impianto, tempoCampionamento, 0)
+{
+    if (!(parametri.bandaFiltro > 0) || !(impianto.guadagno > 0))
+    {
+        throw invalid_argument("OsservatoreDisturbo: parametri non validi");
+    }
+
+    // Doppio polo in -w: e^(A Tc) = e^(-w Tc) [1 + w Tc, Tc; -w^2 Tc, 1 - w Tc], B = [0, w^2]
+    const double w = parametri.bandaFiltro, Tc = tempoCampionamento;
+    const double decadimento = exp(-w * Tc);
+    phi11 = decadimento * (1 + w * Tc);
+    phi12 = decadimento * Tc;
+    phi21 = -decadimento * w * w * Tc;
+    phi22 = decadimento * (1 - w * Tc);
+    gamma1 = 1 - phi11;
+    gamma2 = -phi21;
+}
+
+double OsservatoreDisturbo::filtra(double ingresso, double &posizione, double &velocita) const
+{
+    const double w = parametri.bandaFiltro;
+    const double nuovaPosizione = phi11 * posizione + phi12 * velocita + gamma1 * ingresso;
+    velocita = phi21 * posizione + phi22 * velocita + gamma2 * ingresso;
+    posizione = nuovaPosizione;
+    const double accelerazione = w * w * (ingresso - posizione) - 2 * w * velocita;
+    return velocita + impianto.costanteTempo * accelerazione;
+}
+
+float OsservatoreDisturbo::compensazione(float distanzaMisurata, float posizione)
+{
+    disturboOstacolo = filtra(distanzaMisurata - posizione, posizioneOstacolo, velocitaOstacolo) / impianto.guadagno;
+    disturboRobot = filtra(posizione - modello.getPosizione(), posizioneRobot, velocitaRobot) / impianto.guadagno;
+    const double velocita = -(parametri.pesoOstacolo * disturboOstacolo + parametri.pesoRobot * disturboRobot);
+    return (float)clamp(velocita, -impianto.velocitaMassima, impianto.velocitaMassima);
+}
+
+void OsservatoreDisturbo::applica(float uscitaApplicata)
+{
+    modello.passo(uscitaApplicata);
+}
+
+void OsservatoreDisturbo::reset(float distanzaMisurata, float posizione)
+{
+    modello.reset(posizione);
+    posizioneOstacolo = distanzaMisurata - posizione;
+    posizioneRobot = 0;
+    velocitaOstacolo = velocitaRobot = 0;
+    disturboOstacolo = disturboRobot = 0;
+}
@@ -0,0 +1,65 @@
+#ifndef OSSERVATORE_DISTURBO_HPP
+#define OSSERVATORE_DISTURBO_HPP
+
+#include <ModelloMeca500.hpp>
+
+// Parametri dell'osservatore di disturbo
+struct ParametriOsservatoreDisturbo
+{
+    double bandaFiltro = 20;  // rad/s, pulsazione del filtro Q (doppio polo): oltre la banda il rumore del sensore non passa
+    double pesoOstacolo = 1;  // quota del moto dell'ostacolo compensata in avanti
+    double pesoRobot = 1;     // quota della differenza tra robot e modello (guadagno, attriti) compensata in avanti
+};
+
+/*
+    Osservatore del disturbo equivalente in ingresso (DOB) per l'anello della distanza.
+
+    Con la distanza d = x - xo (posizione del robot meno quella dell'ostacolo, negativa come currentDistance)
+    e il modello nominale P(s) = guadagno e^(-ritardo s) / (s (1 + costanteTempo s)) del Meca500, tutto quello
+    che il modello non spiega si riporta a un disturbo w in ingresso: d = P (u + w). Il disturbo ha due parti:
+    - ostacolo: P wo = -xo, con xo = posizione - distanza misurata (Robot::get_position e il sensore)
+    - robot: P wr = x - x^, con x^ la posizione del modello fatto evolvere con la velocità comandata
+    La stima è w^ = Q P^-1 (segnale) senza l'anticipo del ritardo, non realizzabile: con Q = wq^2 / (s + wq)^2
+    il filtro a variabili di stato (discretizzazione esatta con ingresso costante nel periodo) dà direttamente
+    la derivata prima e seconda filtrate del segnale, e w^ = (v + costanteTempo a) / guadagno. Il termine
+    -w^ sommato alla velocità del regolatore compensa in avanti il moto dell'ostacolo (e la differenza del
+    robot dal modello) prima che si veda come errore; il regolatore resta in retroazione su quello che rimane.
+
+    Tutto è calcolato nel costruttore o su variabili membro: un passo costa qualche decina di operazioni,
+    senza allocazioni, e sta nel periodo di 20 ms del ciclo di controllo.
+*/
+class OsservatoreDisturbo
+{
+private:
+    ParametriOsservatoreDisturbo parametri;
+    ParametriMeca500 impianto;
+    ModelloMeca500 modello; // posizione nominale con le velocità applicate
+
+    // Filtro Q a variabili di stato [posizione, velocità]: stato[k+1] = Phi stato[k] + Gamma ingresso[k]
+    double phi11, phi12, phi21, phi22, gamma1, gamma2;
+    double posizioneOstacolo = 0, velocitaOstacolo = 0; // filtro sul segnale -xo
+    double posizioneRobot = 0, velocitaRobot = 0;       // filtro sul segnale x - x^
+    double disturboOstacolo = 0, disturboRobot = 0;
+
+    // Un passo del filtro, restituisce v + costanteTempo a filtrate (P^-1 senza ritardo, a meno del guadagno)
+    double filtra(double ingresso, double &posizione, double &velocita) const;
+
+public:
+    OsservatoreDisturbo(const ParametriMeca500 &impianto, double tempoCampionamento,
+                        const ParametriOsservatoreDisturbo &parametri = ParametriOsservatoreDisturbo());
+
+    // Velocità da sommare a quella del regolatore, con la distanza misurata (negativa, mm) e la posizione del robot (mm)
+    float compensazione(float distanzaMisurata, float posizione);
+
+    // Da chiamare a ogni campione con la velocità complessiva effettivamente inviata al robot
+    void applica(float uscitaApplicata);
+
+    // Robot fermo con la distanza e la posizione indicate (avvio, ripartenza dopo una pausa o l'ostacolo fuori portata)
+    void reset(float distanzaMisurata, float posizione);
+
+    // Ultime stime del disturbo in ingresso in mm/s (il moto dell'ostacolo in avanti è negativo)
+    double getDisturboOstacolo() const { return disturboOstacolo; }
+    double getDisturboRobot() const { return disturboRobot; }
+};
+
+#endif
@@ -0,0 +1,101 @@
+#include <Polinomi.hpp>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+#define MAX_ITERAZIONI_RADICI 1000
+#define TOLLERANZA_RADICI 1e-15
+
+vector<complex<double>> radiciPolinomio(const vector<double> &coefficienti)
+{
+    // Elimina i coefficienti nulli in testa
+    size_t inizio = 0;
+    while (inizio < coefficienti.size() && coefficienti[inizio] == 0)
+    {
+        inizio++;
+    }
+    if (inizio == coefficienti.size())
+    {
+        throw invalid_argument("radiciPolinomio: polinomio nullo");
+    }
+
+    // Le radici nulle dovute ai coefficienti nulli in coda sono aggiunte esattamente
+    size_t fine = coefficienti.size();
+    vector<complex<double>> radici;
+    while (fine - 1 > inizio && coefficienti[fine - 1] == 0)
+    {
+        radici.push_back(0.0);
+        fine--;
+    }
+
+    // Polinomio monico rimanente
+    vector<double> monico(coefficienti.begin() + inizio, coefficienti.begin() + fine);
+    for (double &c : monico)
+    {
+        c /= coefficienti[inizio];
+    }
+    size_t grado = monico.size() - 1;
+    if (grado == 0)
+    {
+        return radici;
+    }
+
+    // Durand-Kerner: tutte le radici sono aggiornate simultaneamente a partire da punti non simmetrici
+    double raggio = 1;
+    for (size_t i = 1; i <= grado; i++)
+    {
+        raggio = max(raggio, 2 * fabs(monico[i]));
+    }
+    vector<complex<double>> z(grado);
+    for (size_t i = 0; i < grado; i++)
+    {
+        z[i] = raggio * pow(complex<double>(0.4, 0.9), (double)i);
+    }
+
+    for (int iterazione = 0; iterazione < MAX_ITERAZIONI_RADICI; iterazione++)
+    {
+        double massimaVariazione = 0;
+        for (size_t i = 0; i < grado; i++)
+        {
+            complex<double> valore = 1;
+            for (size_t j = 1; j <= grado; j++)
+            {
+                valore = valore * z[i] + monico[j];
+            }
+            complex<double> denominatore = 1;
+            for (size_t j = 0; j < grado; j++)
+            {
+                if (j != i)
+                {
+                    denominatore *= z[i] - z[j];
+                }
+            }
+            complex<double> variazione = (denominatore == 0.0) ? complex<double>(TOLLERANZA_RADICI, 0) : valore / denominatore;
+            z[i] -= variazione;
+            massimaVariazione = max(massimaVariazione, abs(variazione) / max(1.0, abs(z[i])));
+        }
+        if (massimaVariazione < TOLLERANZA_RADICI)
+        {
+            break;
+        }
+    }
+
+    radici.insert(radici.end(), z.begin(), z.end());
+    return radici;
+}
+
+vector<complex<double>> polinomioDaRadici(const vector<complex<double>> &radici)
+{
+    vector<complex<double>> coefficienti{1.0};
+    for (const complex<double> &r : radici)
+    {
+        coefficienti.push_back(0.0);
+        for (size_t i = coefficienti.size() - 1; i > 0; i--)
+        {
+            coefficienti[i] -= r * coefficienti[i - 1];
+        }
+    }
+    return coefficienti;
+}
@@ -0,0 +1,14 @@
+#ifndef POLINOMI_HPP
+#define POLINOMI_HPP
+
+#include <complex>
+#include <vector>
+
+// Radici del polinomio c[0] x^n + c[1] x^(n-1) + ... + c[n] (metodo di Durand-Kerner in doppia precisione).
+// I coefficienti nulli in testa sono ignorati; le radici nulle dovute ai coefficienti nulli in coda sono esatte.
+std::vector<std::complex<double>> radiciPolinomio(const std::vector<double> &coefficienti);
+
+// Coefficienti (potenze decrescenti, monico) del polinomio con le radici date, prodotto dei fattori (x - r)
+std::vector<std::complex<double>> polinomioDaRadici(const std::vector<std::complex<double>> &radici);
+
+#endif
@@ -0,0 +1,162 @@
+#include <PoolThread.hpp>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+PoolThread::PoolThread(size_t numeroThread)
+{
+    if (numeroThread == 0)
+    {
+        numeroThread = max(1u, thread::hardware_concurrency());
+    }
+    intervalli.reset(new Intervallo[numeroThread]);
+    threads.reserve(numeroThread);
+    for (size_t i = 0; i < numeroThread; i++)
+    {
+        threads.emplace_back(&PoolThread::ciclo, this, i);
+    }
+}
+
+PoolThread::~PoolThread()
+{
+    {
+        lock_guard<std::mutex> lock(mutex);
+        termina = true;
+    }
+    condizioneLavoro.notify_all();
+    for (thread &t : threads)
+    {
+        t.join();
+    }
+}
+
+void PoolThread::parallelFor(size_t numeroElementi, size_t blocco, const Lavoro &lavoro)
+{
+    if (blocco == 0)
+    {
+        throw invalid_argument("PoolThread: la dimensione del blocco deve essere positiva");
+    }
+    if (numeroElementi == 0)
+    {
+        return;
+    }
+
+    // Distribuzione iniziale uniforme, il bilanciamento fine è lasciato ai furti
+    const size_t numeroThread = threads.size();
+    for (size_t i = 0; i < numeroThread; i++)
+    {
+        lock_guard<std::mutex> lock(intervalli[i].mutex);
+        intervalli[i].inizio = numeroElementi * i / numeroThread;
+        intervalli[i].fine = numeroElementi * (i + 1) / numeroThread;
+    }
+    furti = 0;
+
+    unique_lock<std::mutex> lock(mutex);
+    lavoroAttuale = &lavoro;
+    dimensioneBlocco = blocco;
+    eccezione = nullptr;
+    threadOccupati = numeroThread;
+    generazione++;
+    condizioneLavoro.notify_all();
+    condizioneFine.wait(lock, [this]
+                        { return threadOccupati == 0; });
+    lavoroAttuale = nullptr;
+
+    if (eccezione)
+    {
+        rethrow_exception(eccezione);
+    }
+}
+
+void PoolThread::ciclo(size_t indice)
+{
+    size_t generazioneEseguita = 0;
+    while (true)
+    {
+        const Lavoro *lavoro;
+        {
+            unique_lock<std::mutex> lock(mutex);
+            condizioneLavoro.wait(lock, [&]
+                                  { return termina || generazione != generazioneEseguita; });
+            if (termina)
+            {
+                return;
+            }
+            generazioneEseguita = generazione;
+            lavoro = lavoroAttuale;
+        }
+
+        size_t inizio, fine;
+        try
+        {
+            while (prendiBlocco(indice, inizio, fine) || (ruba(indice) && prendiBlocco(indice, inizio, fine)))
+            {
+                (*lavoro)(inizio, fine, indice);
+            }
+        }
+        catch (...)
+        {
+            // Il primo errore interrompe il lavoro di tutti i thread
+            lock_guard<std::mutex> lock(mutex);
+            if (!eccezione)
+            {
+                eccezione = current_exception();
+            }
+            for (size_t i = 0; i < threads.size(); i++)
+            {
+                lock_guard<std::mutex> lockIntervallo(intervalli[i].mutex);
+                intervalli[i].inizio = intervalli[i].fine;
+            }
+        }
+
+        lock_guard<std::mutex> lock(mutex);
+        if (--threadOccupati == 0)
+        {
+            condizioneFine.notify_one();
+        }
+    }
+}
+
+bool PoolThread::prendiBlocco(size_t indice, size_t &inizio, size_t &fine)
+{
+    Intervallo &intervallo = intervalli[indice];
+    lock_guard<std::mutex> lock(intervallo.mutex);
+    if (intervallo.inizio >= intervallo.fine)
+    {
+        return false;
+    }
+    inizio = intervallo.inizio;
+    fine = min(intervallo.fine, inizio + dimensioneBlocco);
+    intervallo.inizio = fine;
+    return true;
+}
+
+bool PoolThread::ruba(size_t indice)
+{
+    const size_t numeroThread = threads.size();
+    // Vittime in ordine a partire dal thread successivo, per non concentrare i furti sul thread 0
+    for (size_t passo = 1; passo < numeroThread; passo++)
+    {
+        Intervallo &vittima = intervalli[(indice + passo) % numeroThread];
+        size_t inizio, fine;
+        {
+            lock_guard<std::mutex> lock(vittima.mutex);
+            size_t rimanenti = vittima.fine - min(vittima.inizio, vittima.fine);
+            if (rimanenti <= dimensioneBlocco)
+            {
+                continue; // la vittima sta per finire, non conviene dividere
+            }
+            fine = vittima.fine;
+            inizio = vittima.fine - rimanenti / 2;
+            vittima.fine = inizio;
+        }
+        Intervallo &proprio = intervalli[indice];
+        lock_guard<std::mutex> lock(proprio.mutex);
+        proprio.inizio = inizio;
+        proprio.fine = fine;
+        furti++;
+        return true;
+    }
+    return false;
+}
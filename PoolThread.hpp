@@ -0,0 +1,70 @@
+#ifndef POOL_THREAD_HPP
+#define POOL_THREAD_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+    Pool di thread con work stealing per le analisi offline (autotune, Monte Carlo, ...).
+
+    parallelFor divide gli indici [0, n) in un intervallo contiguo per thread. Ogni thread consuma il
+    proprio intervallo dall'inizio a blocchi di dimensione fissa; quando lo ha esaurito ruba la metà finale
+    dell'intervallo di un altro thread, così i thread che trovano lavoro più leggero aiutano gli altri
+    senza una coda centrale da contendere.
+*/
+class PoolThread
+{
+public:
+    // lavoro(inizio, fine, indiceThread): elabora gli indici [inizio, fine)
+    using Lavoro = std::function<void(std::size_t, std::size_t, std::size_t)>;
+
+    // numeroThread = 0 usa tutti i core disponibili
+    explicit PoolThread(std::size_t numeroThread = 0);
+    ~PoolThread();
+
+    PoolThread(const PoolThread &) = delete;
+    PoolThread &operator=(const PoolThread &) = delete;
+
+    // Esegue lavoro su tutti gli indici [0, numeroElementi) e ritorna quando sono stati elaborati tutti;
+    // un'eccezione lanciata da un thread viene rilanciata qui
+    void parallelFor(std::size_t numeroElementi, std::size_t blocco, const Lavoro &lavoro);
+
+    std::size_t getNumeroThread() const { return threads.size(); }
+    // Numero di intervalli rubati durante l'ultimo parallelFor
+    std::size_t getFurti() const { return furti.load(); }
+
+private:
+    struct alignas(64) Intervallo
+    {
+        std::mutex mutex;
+        std::size_t inizio = 0;
+        std::size_t fine = 0;
+    };
+
+    std::unique_ptr<Intervallo[]> intervalli;
+    std::vector<std::thread> threads;
+
+    std::mutex mutex;
+    std::condition_variable condizioneLavoro;
+    std::condition_variable condizioneFine;
+    const Lavoro *lavoroAttuale = nullptr;
+    std::size_t dimensioneBlocco = 1;
+    std::size_t generazione = 0;
+    std::size_t threadOccupati = 0;
+    bool termina = false;
+    std::exception_ptr eccezione;
+    std::atomic<std::size_t> furti{0};
+
+    void ciclo(std::size_t indice);
+    bool prendiBlocco(std::size_t indice, std::size_t &inizio, std::size_t &fine);
+    bool ruba(std::size_t indice);
+};
+
+#endif
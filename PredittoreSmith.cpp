@@ -0,0 +1,57 @@
+#include <PredittoreSmith.hpp>
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace
+{
+    ParametriMeca500 senzaRitardo(ParametriMeca500 impianto)
+    {
+        impianto.ritardo = 0;
+        return impianto;
+    }
+}
+
+PredittoreSmith::PredittoreSmith(const ParametriMeca500 &impianto, double tempoCampionamento)
+    : modelloRitardato(impianto, tempoCampionamento, 0), modelloSenzaRitardo(senzaRitardo(impianto), tempoCampionamento, 0),
+      tempoCampionamento(tempoCampionamento), ritardo(impianto.ritardo)
+{
+}
+
+float PredittoreSmith::correggi(float errore) const
+{
+    return errore - (float)(modelloSenzaRitardo.getPosizione() - modelloRitardato.getPosizione());
+}
+
+void PredittoreSmith::applica(float uscitaApplicata)
+{
+    modelloRitardato.passo(uscitaApplicata);
+    modelloSenzaRitardo.passo(uscitaApplicata);
+
+    // Solo la differenza conta: il modello con ritardo torna nell'origine
+    modelloSenzaRitardo.setPosizione(modelloSenzaRitardo.getPosizione() - modelloRitardato.getPosizione());
+    modelloRitardato.setPosizione(0);
+}
+
+void PredittoreSmith::reset(float velocita)
+{
+    modelloRitardato.reset(0, velocita);
+    modelloSenzaRitardo.reset(0, velocita);
+}
+
+void PredittoreSmith::setRitardo(double nuovoRitardo)
+{
+    if (!std::isfinite(nuovoRitardo))
+    {
+        return;
+    }
+    // Sotto il limite di ModelloMeca500 anche con l'arrotondamento di floor(ritardo / Tc)
+    ritardo = clamp(nuovoRitardo, 0.0, MAX_RITARDO_CAMPIONI * tempoCampionamento);
+    modelloRitardato.setRitardo(ritardo);
+}
+
+void PredittoreSmith::aggiornaRitardo(double ritardoMisurato, double peso)
+{
+    setRitardo(ritardo + peso * (ritardoMisurato - ritardo));
+}
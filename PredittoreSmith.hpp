@@ -0,0 +1,114 @@
+#ifndef PREDITTORE_SMITH_HPP
+#define PREDITTORE_SMITH_HPP
+
+#include <ModelloMeca500.hpp>
+#include <SimulatoreAnelloChiuso.hpp>
+
+// Peso di default della nuova misura nel filtro esponenziale del ritardo (costante di circa 20 campioni)
+#define PESO_MISURA_RITARDO 0.05
+
+/*
+    Predittore di Smith per il tempo morto dell'anello: ritardo interno del Meca500, lettura seriale del
+    sensore (richiesta "a" e risposta in getDistanceInMillimetersVector) e calcolo del periodo.
+
+    Due copie del modello identificato (ModelloMeca500) sono fatte evolvere con la velocità effettivamente
+    inviata al robot, una con il ritardo e una senza. La differenza tra le due posizioni è lo spostamento
+    che il robot ha già ricevuto come comando ma che la misura non vede ancora: il regolatore lavora con
+    l'errore corretto
+
+        errore - (posizione senza ritardo - posizione con ritardo)
+
+    cioè con l'errore previsto a fine ritardo, e l'anello equivalente è quello dell'impianto senza tempo
+    morto, con più margine di fase per alzare la banda. Con il modello esatto la correzione compensa il
+    ritardo; gli errori del modello restano corretti dalla misura, come nel regolatore senza predittore.
+    Dopo ogni passo le due posizioni sono traslate insieme (la correzione dipende solo dalla differenza),
+    così non crescono con il robot che si muove nello stesso verso.
+
+    Il ritardo si può cambiare a ciclo in funzione (setRitardo, aggiornaRitardo con il filtro sulla latenza
+    misurata): i comandi in coda nel modello restano quelli inviati e non ci sono allocazioni.
+*/
+class PredittoreSmith
+{
+private:
+    ModelloMeca500 modelloRitardato;
+    ModelloMeca500 modelloSenzaRitardo;
+    double tempoCampionamento;
+    double ritardo;
+
+public:
+    PredittoreSmith(const ParametriMeca500 &impianto, double tempoCampionamento);
+
+    // Errore previsto a fine ritardo, da passare al regolatore al posto di quello misurato
+    float correggi(float errore) const;
+
+    // Da chiamare a ogni campione con la velocità effettivamente inviata al robot
+    void applica(float uscitaApplicata);
+
+    // Robot a regime con la velocità indicata (ripartenza dopo una pausa o l'ostacolo fuori portata)
+    void reset(float velocita = 0);
+
+    // Nuovo tempo morto in secondi, limitato a quello rappresentabile dal modello
+    void setRitardo(double nuovoRitardo);
+
+    // Filtro esponenziale verso il ritardo misurato: ritardo += peso * (ritardoMisurato - ritardo)
+    void aggiornaRitardo(double ritardoMisurato, double peso = PESO_MISURA_RITARDO);
+
+    double getRitardo() const { return ritardo; }
+};
+
+/*
+    Predittore di Smith attorno a un qualunque regolatore (Regolatore, RegolatoreFisso, RegolatoreStatoSpazio,
+    ...), con la stessa interfaccia di RegolatoreStatoSpazio: si usa direttamente con SimulatoreAnelloChiuso e
+    valutaRegolatore. Se il regolatore ha l'anti-windup (HaAntiWindup) riceve anche la velocità applicata e
+    l'inizializzazione bumpless, altrimenti viene resettato.
+*/
+template <typename R>
+class RegolatoreSmith
+{
+private:
+    R &regolatore;
+    PredittoreSmith predittore;
+
+public:
+    RegolatoreSmith(R &regolatore, const ParametriMeca500 &impianto, double tempoCampionamento)
+        : regolatore(regolatore), predittore(impianto, tempoCampionamento)
+    {
+    }
+
+    float calculate_output(float errore)
+    {
+        return regolatore.calculate_output(predittore.correggi(errore));
+    }
+
+    void applica(float uscitaApplicata)
+    {
+        if constexpr (HaAntiWindup<R>::value)
+        {
+            regolatore.applica(uscitaApplicata);
+        }
+        predittore.applica(uscitaApplicata);
+    }
+
+    void inizializza(float errore, float uscita)
+    {
+        predittore.reset(uscita);
+        if constexpr (HaAntiWindup<R>::value)
+        {
+            regolatore.inizializza(predittore.correggi(errore), uscita);
+        }
+        else
+        {
+            regolatore.reset();
+        }
+    }
+
+    void reset()
+    {
+        predittore.reset();
+        regolatore.reset();
+    }
+
+    PredittoreSmith &getPredittore() { return predittore; }
+};
+
+#endif
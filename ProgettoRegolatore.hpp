@@ -0,0 +1,167 @@
+#ifndef PROGETTO_REGOLATORE_HPP
+#define PROGETTO_REGOLATORE_HPP
+
+#include <array>
+#include <complex>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+#include <Discretizzazione.hpp>
+#include <RegolatoreFisso.hpp>
+
+/*
+    Progetto del regolatore a tempo di compilazione, a partire da zeri, poli e guadagno in z:
+
+    R(z) = guadagno * (1 - zeri[0] z^-1) ... (1 - zeri[m-1] z^-1) / ((1 - poli[0] z^-1) ... (1 - poli[n-1] z^-1))
+
+    constexpr auto PROGETTO = progetta(zeri{0.7967}, poli{0.6, 0.6}, guadagno{1.6334});
+    RegolatoreFisso<1, 2> regolatore = make_regulator(PROGETTO);
+
+    I polinomi sono espansi dal compilatore e make_regulator restituisce il RegolatoreFisso dell'ordine giusto
+    (prodotti scalari srotolati, nessuna allocazione). make_regulator è consteval: accetta solo progetti noti a
+    tempo di compilazione, quindi un polo fuori dal cerchio unitario è sempre un errore di compilazione e mai
+    un'eccezione a tempo di esecuzione (verificato da verifica_progetto_costante.cpp con try_compile).
+    progetta() resta constexpr per i progetti calcolati a tempo di esecuzione (autotune), che lanciano
+    invalid_argument; ProgettoRegolatore::stabile() è disponibile per static_assert espliciti.
+    Solo zeri e poli reali.
+*/
+
+template <std::size_t N>
+struct zeri
+{
+    std::array<double, N> valori{};
+
+    template <typename... V>
+    constexpr explicit zeri(V... v) : valori{{static_cast<double>(v)...}} {}
+};
+template <typename... V>
+zeri(V...) -> zeri<sizeof...(V)>;
+
+template <std::size_t N>
+struct poli
+{
+    std::array<double, N> valori{};
+
+    template <typename... V>
+    constexpr explicit poli(V... v) : valori{{static_cast<double>(v)...}} {}
+};
+template <typename... V>
+poli(V...) -> poli<sizeof...(V)>;
+
+struct guadagno
+{
+    double valore;
+
+    constexpr explicit guadagno(double valore) : valore(valore) {}
+};
+
+// Coefficienti (potenze crescenti di z^-1) di (1 - radici[0] z^-1) ... (1 - radici[N-1] z^-1)
+template <std::size_t N>
+constexpr std::array<double, N + 1> polinomioDaRadiciReali(const std::array<double, N> &radici)
+{
+    std::array<double, N + 1> coefficienti{};
+    coefficienti[0] = 1;
+    for (std::size_t i = 0; i < N; i++)
+    {
+        for (std::size_t j = i + 1; j > 0; j--)
+        {
+            coefficienti[j] -= radici[i] * coefficienti[j - 1];
+        }
+    }
+    return coefficienti;
+}
+
+template <std::size_t NumZeri, std::size_t NumPoli>
+struct ProgettoRegolatore
+{
+    std::array<double, NumZeri> zeri{};
+    std::array<double, NumPoli> poli{};
+    double guadagno = 0;
+    // Convenzione di Regolatore: input_coeff per u[k] ... u[k - m], output_coeff per y[k - 1] ... y[k - n]
+    std::array<double, NumZeri + 1> input_coeff{};
+    std::array<double, NumPoli> output_coeff{};
+
+    constexpr bool stabile() const
+    {
+        for (double p : poli)
+        {
+            if (!(p > -1 && p < 1))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+template <std::size_t NumZeri, std::size_t NumPoli>
+constexpr ProgettoRegolatore<NumZeri, NumPoli> progetta(const zeri<NumZeri> &z, const poli<NumPoli> &p, guadagno k)
+{
+    ProgettoRegolatore<NumZeri, NumPoli> progetto;
+    progetto.zeri = z.valori;
+    progetto.poli = p.valori;
+    progetto.guadagno = k.valore;
+    if (!progetto.stabile())
+    {
+        // In un contesto costante l'eccezione diventa un errore di compilazione
+        throw std::invalid_argument("ProgettoRegolatore: i poli devono essere dentro il cerchio unitario");
+    }
+
+    std::array<double, NumZeri + 1> numeratore = polinomioDaRadiciReali(z.valori);
+    for (std::size_t i = 0; i <= NumZeri; i++)
+    {
+        progetto.input_coeff[i] = k.valore * numeratore[i];
+    }
+    std::array<double, NumPoli + 1> denominatore = polinomioDaRadiciReali(p.valori);
+    for (std::size_t i = 0; i < NumPoli; i++)
+    {
+        progetto.output_coeff[i] = -denominatore[i + 1];
+    }
+    return progetto;
+}
+
+template <typename T = float, std::size_t NumZeri, std::size_t NumPoli>
+consteval RegolatoreFisso<NumZeri, NumPoli, T> make_regulator(const ProgettoRegolatore<NumZeri, NumPoli> &progetto)
+{
+    std::array<T, NumPoli> output_coeff{};
+    std::array<T, NumZeri + 1> input_coeff{};
+    for (std::size_t i = 0; i < NumPoli; i++)
+    {
+        output_coeff[i] = static_cast<T>(progetto.output_coeff[i]);
+    }
+    for (std::size_t i = 0; i <= NumZeri; i++)
+    {
+        input_coeff[i] = static_cast<T>(progetto.input_coeff[i]);
+    }
+    return RegolatoreFisso<NumZeri, NumPoli, T>(output_coeff, input_coeff);
+}
+
+template <typename T = float, std::size_t NumZeri, std::size_t NumPoli>
+consteval RegolatoreFisso<NumZeri, NumPoli, T> make_regulator(const zeri<NumZeri> &z, const poli<NumPoli> &p, guadagno k)
+{
+    return make_regulator<T>(progetta(z, p, k));
+}
+
+// Coefficienti per i regolatori a tempo di esecuzione (Regolatore, RegolatoreStatoSpazio, ...)
+template <std::size_t NumZeri, std::size_t NumPoli>
+CoefficientiRegolatore coefficientiProgetto(const ProgettoRegolatore<NumZeri, NumPoli> &progetto)
+{
+    return {std::vector<double>(progetto.output_coeff.begin(), progetto.output_coeff.end()),
+            std::vector<double>(progetto.input_coeff.begin(), progetto.input_coeff.end())};
+}
+
+// Regolatore tempo continuo equivalente (continuaDaPoliZeri), per ridiscretizzarlo con un altro periodo
+template <std::size_t NumZeri, std::size_t NumPoli>
+FunzioneTrasferimentoContinua funzioneContinuaProgetto(const ProgettoRegolatore<NumZeri, NumPoli> &progetto, double tempoCampionamento)
+{
+    return continuaDaPoliZeri(std::vector<std::complex<double>>(progetto.zeri.begin(), progetto.zeri.end()),
+                              std::vector<std::complex<double>>(progetto.poli.begin(), progetto.poli.end()),
+                              progetto.guadagno, tempoCampionamento);
+}
+
+// Progetto del regolatore del ciclo di controllo, a 50 Hz (condiviso da test_regolatore, regulator e dai tool)
+#define TEMPO_CAMPIONAMENTO_PROGETTO 0.02
+inline constexpr ProgettoRegolatore<1, 2> PROGETTO_REGOLATORE = progetta(zeri{0.7967}, poli{0.6, 0.6}, guadagno{1.6334});
+static_assert(PROGETTO_REGOLATORE.stabile(), "il regolatore di progetto deve essere stabile");
+
+#endif
@@ -1,51 +1,45 @@
-#include <iostream>
-#include <numeric>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
 #include <vector>
 #include <Regolatore.hpp>
 using namespace std;
 
 // Resetta tutte le variabili di stato a 0
 void Regolatore::reset(){
-    previous_inputs.resize(previous_inputs.size(), 0);
-    previous_outputs.resize(previous_outputs.size(), 0);
+    formaDiretta.reset();
+    formaSezioni.reset();
 }
 
 float Regolatore::calculate_output(float input)
 {
-    // Aggiorna il vettore degli ingressi precedenti spostando tutti i valori di un posto in avanti
-    for (int i = previous_inputs.size() - 1; i > 0; i--)
+    if (forma == FORMA_SEZIONI)
     {
-        previous_inputs[i] = previous_inputs[i - 1];
+        return formaSezioni.calculate_output(input);
     }
-    // Il valore nella prima posizione corrisponde all'ingresso attuale
-    previous_inputs[0] = input;
-    // Il contributo dell'ingresso all'uscita è il prodotto scalare tra il vettore degli ingressi precedenti che comprende quello attuale
-    // e i coefficienti relativi agli ingressi della funzione di trasferimento del regolatore
-    float output_input_component = inner_product(previous_inputs.begin(), previous_inputs.end(), input_coefficients.begin(), 0.0);
-
-    // Il contributo dell'uscita precedente all'uscita attuale è il prodotto scalare tra il vettore delle uscite precedenti
-    // e i coefficienti relativi all'uscita della funzione di trasferimento del regolatore
-    float output_output_component = inner_product(previous_outputs.begin(), previous_outputs.end(), output_coefficients.begin(), 0.0);
-
-    
-    for (int i = previous_outputs.size() - 1; i > 0; i--)
-    {
-        previous_outputs[i] = previous_outputs[i - 1];
-    }
-    previous_outputs[0] = output_input_component + output_output_component;
+    return formaDiretta.calculate_output(input);
+}
 
-    
-    return previous_outputs[0];
+Regolatore::Regolatore(vector<float> output_coeff, vector<float> input_coeff, Forma forma)
+    : Regolatore(vector<double>(output_coeff.begin(), output_coeff.end()), vector<double>(input_coeff.begin(), input_coeff.end()), forma)
+{
 }
 
-Regolatore::Regolatore(vector<float> output_coeff, vector<float> input_coeff)
+Regolatore::Regolatore(vector<double> output_coeff, vector<double> input_coeff, Forma forma) : forma(forma)
 {
-    output_coefficients = output_coeff;
-    input_coefficients = input_coeff;
+    // input_coeff contiene i coefficienti di u[k] ... u[k - n], output_coeff quelli di y[k - 1] ... y[k - m]
+    if (input_coeff.empty() || input_coeff.size() > ORDINE_MASSIMO_REGOLATORE + 1 || output_coeff.size() > ORDINE_MASSIMO_REGOLATORE)
+    {
+        throw invalid_argument("Regolatore: ordine non supportato (massimo " + to_string(ORDINE_MASSIMO_REGOLATORE) + ")");
+    }
 
-    // Inizializza i vettori dei precedenti ingressi e uscite a zero
-    previous_inputs.resize(output_coefficients.size(), 0);
-    previous_outputs.resize(input_coefficients.size(), 0);
+    if (forma == FORMA_SEZIONI)
+    {
+        formaSezioni = RegolatoreSos<(ORDINE_MASSIMO_REGOLATORE + 1) / 2, float>(convertiInSezioni(output_coeff, input_coeff));
+        return;
+    }
 
+    // I coefficienti non specificati restano a zero e non contribuiscono all'uscita
+    copy(input_coeff.begin(), input_coeff.end(), formaDiretta.coefficientiIngresso().begin());
+    copy(output_coeff.begin(), output_coeff.end(), formaDiretta.coefficientiUscita().begin());
 }
-
@@ -1,19 +1,35 @@
 #ifndef REGOLATORE_HPP
 #define REGOLATORE_HPP
 #include <vector>
+#include <RegolatoreFisso.hpp>
+#include <SezioniSecondoOrdine.hpp>
 using namespace std;
 
+// Ordine massimo del regolatore configurabile a tempo di esecuzione
+#define ORDINE_MASSIMO_REGOLATORE 10
+
+// Adattatore a tempo di esecuzione di RegolatoreFisso e RegolatoreSos: i coefficienti vengono completati
+// fino all'ordine massimo, così il ciclo di controllo non alloca e non sposta gli stati precedenti
 class Regolatore
 {
+public:
+    // Forma di realizzazione del regolatore
+    enum Forma
+    {
+        FORMA_DIRETTA,  // equazione alle differenze con i coefficienti dati
+        FORMA_SEZIONI   // cascata di sezioni del secondo ordine, per regolatori di ordine elevato
+    };
+
 private:
-    vector<float> output_coefficients;
-    vector<float> input_coefficients;
-    vector<float> previous_inputs;
-    vector<float> previous_outputs;
+    Forma forma;
+    RegolatoreFisso<ORDINE_MASSIMO_REGOLATORE, ORDINE_MASSIMO_REGOLATORE, float> formaDiretta;
+    RegolatoreSos<(ORDINE_MASSIMO_REGOLATORE + 1) / 2, float> formaSezioni;
 
 public:
-    Regolatore(vector<float> output_coeff, vector<float> input_coeff);
+    Regolatore(vector<float> output_coeff, vector<float> input_coeff, Forma forma = FORMA_DIRETTA);
+    // Coefficienti in doppia precisione, da preferire con FORMA_SEZIONI per regolatori di ordine elevato
+    Regolatore(vector<double> output_coeff, vector<double> input_coeff, Forma forma = FORMA_DIRETTA);
     float calculate_output(float input);
     void reset();
 };
-#endif
\ No newline at end of file
+#endif
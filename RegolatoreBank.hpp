@@ -0,0 +1,109 @@
+#ifndef REGOLATORE_BANK_HPP
+#define REGOLATORE_BANK_HPP
+
+#include <RegolatoreFisso.hpp>
+#include <VettoreSimd.hpp>
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+
+/*
+    Banco di Channels regolatori tempo discreto indipendenti, tutti dello stesso ordine:
+
+    y_c[k] = b_c[0] * u_c[k] + ... + b_c[NumOrder] * u_c[k - NumOrder] + a_c[0] * y_c[k - 1] + ... + a_c[DenOrder - 1] * y_c[k - DenOrder]
+
+    I coefficienti e gli stati sono memorizzati per struttura di array: ogni riga contiene lo stesso
+    ritardo di tutti i canali, così un campione di tutti i canali si calcola con un solo passaggio
+    vettoriale (SSE/AVX/NEON) per ritardo. Regolare le sei componenti di velocità WRF del Meca500
+    costa quindi circa quanto regolarne una.
+*/
+template <std::size_t Channels, std::size_t NumOrder, std::size_t DenOrder>
+class RegolatoreBank
+{
+public:
+    static constexpr std::size_t CANALI = Channels;
+    static constexpr std::size_t CANALI_SIMD = arrotondaLarghezzaSimd(Channels); // canali compresi quelli di riempimento
+    static constexpr std::size_t NUM_COEFFICIENTI_INGRESSO = NumOrder + 1;
+    static constexpr std::size_t NUM_COEFFICIENTI_USCITA = DenOrder;
+
+private:
+    // Riga di valori relativi allo stesso ritardo per tutti i canali
+    struct alignas(ALLINEAMENTO_SIMD) Riga
+    {
+        float valori[CANALI_SIMD];
+    };
+
+    std::array<Riga, NUM_COEFFICIENTI_INGRESSO> input_coefficients{};
+    std::array<Riga, NUM_COEFFICIENTI_USCITA> output_coefficients{};
+    BufferCircolare<NUM_COEFFICIENTI_INGRESSO, Riga> previous_inputs;
+    BufferCircolare<NUM_COEFFICIENTI_USCITA, Riga> previous_outputs;
+
+    template <std::size_t... I>
+    static VettoreSimd sommaProdotti(VettoreSimd accumulatore, const Riga *coefficienti, const Riga *campioni,
+                                     std::size_t canale, std::index_sequence<I...>)
+    {
+        ((accumulatore = accumulatore + VettoreSimd::carica(coefficienti[I].valori + canale) * VettoreSimd::carica(campioni[I].valori + canale)), ...);
+        return accumulatore;
+    }
+
+public:
+    // Imposta i coefficienti di un canale, con lo stesso ordine dei parametri di Regolatore
+    void setCoefficienti(std::size_t canale,
+                         const std::array<float, NUM_COEFFICIENTI_USCITA> &output_coeff,
+                         const std::array<float, NUM_COEFFICIENTI_INGRESSO> &input_coeff)
+    {
+        if (canale >= CANALI)
+        {
+            throw std::out_of_range("RegolatoreBank: canale inesistente");
+        }
+        for (std::size_t i = 0; i < NUM_COEFFICIENTI_INGRESSO; i++)
+        {
+            input_coefficients[i].valori[canale] = input_coeff[i];
+        }
+        for (std::size_t i = 0; i < NUM_COEFFICIENTI_USCITA; i++)
+        {
+            output_coefficients[i].valori[canale] = output_coeff[i];
+        }
+    }
+
+    // Calcola l'uscita di tutti i canali a partire dai Channels ingressi attuali
+    void calculate_output(const float *input, float *output)
+    {
+        Riga ingresso;
+        for (std::size_t c = 0; c < CANALI_SIMD; c += VettoreSimd::LARGHEZZA)
+        {
+            std::size_t validi = (CANALI - c < VettoreSimd::LARGHEZZA) ? CANALI - c : VettoreSimd::LARGHEZZA;
+            VettoreSimd::componi(input + c, validi).salva(ingresso.valori + c);
+        }
+        previous_inputs.inserisci(ingresso);
+
+        Riga uscita;
+        for (std::size_t c = 0; c < CANALI_SIMD; c += VettoreSimd::LARGHEZZA)
+        {
+            VettoreSimd accumulatore = sommaProdotti(VettoreSimd::zero(), input_coefficients.data(), previous_inputs.finestra(),
+                                                     c, std::make_index_sequence<NUM_COEFFICIENTI_INGRESSO>{});
+            if constexpr (NUM_COEFFICIENTI_USCITA > 0)
+            {
+                accumulatore = sommaProdotti(accumulatore, output_coefficients.data(), previous_outputs.finestra(),
+                                             c, std::make_index_sequence<NUM_COEFFICIENTI_USCITA>{});
+            }
+            accumulatore.salva(uscita.valori + c);
+        }
+        previous_outputs.inserisci(uscita);
+
+        for (std::size_t c = 0; c < CANALI; c++)
+        {
+            output[c] = uscita.valori[c];
+        }
+    }
+
+    // Resetta le variabili di stato di tutti i canali a 0
+    void reset()
+    {
+        previous_inputs.azzera();
+        previous_outputs.azzera();
+    }
+};
+
+#endif
@@ -0,0 +1,117 @@
+#ifndef REGOLATORE_FISSO_HPP
+#define REGOLATORE_FISSO_HPP
+
+#include <array>
+#include <cstddef>
+#include <utility>
+
+// Buffer circolare "specchiato": ogni campione viene scritto in due posizioni (i e i + N)
+// così che gli ultimi N campioni siano sempre contigui a partire dall'indice di testa.
+// L'inserimento è O(1) e la lettura non richiede né spostamenti né operazioni di modulo.
+template <std::size_t N, typename T>
+class BufferCircolare
+{
+private:
+    std::array<T, 2 * N> campioni{};
+    std::size_t testa = 0;
+
+public:
+    // Inserisce il campione più recente
+    void inserisci(const T &valore)
+    {
+        testa = (testa == 0) ? N - 1 : testa - 1;
+        campioni[testa] = valore;
+        campioni[testa + N] = valore;
+    }
+
+    // Finestra degli ultimi N campioni, dal più recente al più vecchio
+    const T *finestra() const { return campioni.data() + testa; }
+
+    void azzera()
+    {
+        campioni.fill(T{});
+        testa = 0;
+    }
+};
+
+// Specializzazione vuota per regolatori senza memoria (ordine del denominatore nullo)
+template <typename T>
+class BufferCircolare<0, T>
+{
+public:
+    void inserisci(const T &) {}
+    const T *finestra() const { return nullptr; }
+    void azzera() {}
+};
+
+// Prodotto scalare srotolato a tempo di compilazione
+template <typename T, std::size_t... I>
+inline T prodottoScalare(const T *coefficienti, const T *campioni, std::index_sequence<I...>)
+{
+    return ((coefficienti[I] * campioni[I]) + ... + T(0));
+}
+
+/*
+    Regolatore tempo discreto di ordine fissato:
+
+    y[k] = b[0] * u[k] + ... + b[NumOrder] * u[k - NumOrder] + a[0] * y[k - 1] + ... + a[DenOrder - 1] * y[k - DenOrder]
+
+    Tutta la memoria è allocata staticamente (std::array), lo stato è mantenuto in buffer circolari
+    e i prodotti scalari sono srotolati dal compilatore: calculate_output non alloca e non sposta
+    gli stati precedenti.
+*/
+template <std::size_t NumOrder, std::size_t DenOrder, typename T = float>
+class RegolatoreFisso
+{
+public:
+    static constexpr std::size_t NUM_COEFFICIENTI_INGRESSO = NumOrder + 1;
+    static constexpr std::size_t NUM_COEFFICIENTI_USCITA = DenOrder;
+
+private:
+    std::array<T, NUM_COEFFICIENTI_INGRESSO> input_coefficients{};
+    std::array<T, NUM_COEFFICIENTI_USCITA> output_coefficients{};
+    BufferCircolare<NUM_COEFFICIENTI_INGRESSO, T> previous_inputs;
+    BufferCircolare<NUM_COEFFICIENTI_USCITA, T> previous_outputs;
+
+public:
+    constexpr RegolatoreFisso() = default;
+
+    // Stesso ordine dei parametri del Regolatore a tempo di esecuzione: prima i coefficienti delle uscite.
+    // constexpr: un regolatore progettato a tempo di compilazione (ProgettoRegolatore.hpp) può essere una costante
+    constexpr RegolatoreFisso(const std::array<T, NUM_COEFFICIENTI_USCITA> &output_coeff,
+                              const std::array<T, NUM_COEFFICIENTI_INGRESSO> &input_coeff)
+        : input_coefficients(input_coeff), output_coefficients(output_coeff)
+    {
+    }
+
+    T calculate_output(T input)
+    {
+        previous_inputs.inserisci(input);
+
+        // Contributo degli ingressi, compreso quello attuale
+        T output = prodottoScalare(input_coefficients.data(), previous_inputs.finestra(),
+                                   std::make_index_sequence<NUM_COEFFICIENTI_INGRESSO>{});
+
+        // Contributo delle uscite precedenti
+        if constexpr (NUM_COEFFICIENTI_USCITA > 0)
+        {
+            output += prodottoScalare(output_coefficients.data(), previous_outputs.finestra(),
+                                      std::make_index_sequence<NUM_COEFFICIENTI_USCITA>{});
+        }
+
+        previous_outputs.inserisci(output);
+        return output;
+    }
+
+    // Resetta tutte le variabili di stato a 0
+    void reset()
+    {
+        previous_inputs.azzera();
+        previous_outputs.azzera();
+    }
+
+    std::array<T, NUM_COEFFICIENTI_INGRESSO> &coefficientiIngresso() { return input_coefficients; }
+    std::array<T, NUM_COEFFICIENTI_USCITA> &coefficientiUscita() { return output_coefficients; }
+};
+
+#endif
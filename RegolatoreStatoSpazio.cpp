@@ -0,0 +1,105 @@
+#include <RegolatoreStatoSpazio.hpp>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+CoefficientiFissi::CoefficientiFissi(const vector<double> &output_coeff, const vector<double> &input_coeff)
+{
+    // input_coeff contiene i coefficienti di u[k] ... u[k - n], output_coeff quelli di y[k - 1] ... y[k - m]
+    if (input_coeff.empty() || input_coeff.size() > ORDINE_MASSIMO_REGOLATORE + 1 || output_coeff.size() > ORDINE_MASSIMO_REGOLATORE)
+    {
+        throw invalid_argument("CoefficientiFissi: ordine non supportato (massimo " + to_string(ORDINE_MASSIMO_REGOLATORE) + ")");
+    }
+    copy(input_coeff.begin(), input_coeff.end(), this->input_coeff.begin());
+    copy(output_coeff.begin(), output_coeff.end(), this->output_coeff.begin());
+    numeroIngresso = input_coeff.size();
+    numeroUscita = output_coeff.size();
+}
+
+RegolatoreStatoSpazio::RegolatoreStatoSpazio(const vector<double> &output_coeff, const vector<double> &input_coeff, double guadagnoAntiWindup)
+    : guadagnoAntiWindup(guadagnoAntiWindup)
+{
+    if (guadagnoAntiWindup < 0 || guadagnoAntiWindup > 1)
+    {
+        throw invalid_argument("RegolatoreStatoSpazio: il guadagno di anti-windup deve essere compreso tra 0 e 1");
+    }
+    setCoefficienti(CoefficientiFissi(output_coeff, input_coeff), 0);
+}
+
+RegolatoreStatoSpazio::RegolatoreStatoSpazio(const vector<float> &output_coeff, const vector<float> &input_coeff, double guadagnoAntiWindup)
+    : RegolatoreStatoSpazio(vector<double>(output_coeff.begin(), output_coeff.end()), vector<double>(input_coeff.begin(), input_coeff.end()), guadagnoAntiWindup)
+{
+}
+
+float RegolatoreStatoSpazio::calculate_output(float input)
+{
+    double uscita = input_coefficients[0] * input + stato[0];
+    for (size_t i = 0; i < ordine; i++)
+    {
+        stato[i] = input_coefficients[i + 1] * input + output_coefficients[i] * uscita + stato[i + 1];
+    }
+    ultimoIngresso = input;
+    ultimaUscita = uscita;
+    return uscita;
+}
+
+void RegolatoreStatoSpazio::applica(float uscitaApplicata)
+{
+    // Lo stato dipende linearmente dall'uscita usata nell'aggiornamento: basta correggere la differenza
+    double correzione = guadagnoAntiWindup * (uscitaApplicata - ultimaUscita);
+    for (size_t i = 0; i < ordine; i++)
+    {
+        stato[i] += output_coefficients[i] * correzione;
+    }
+    ultimaUscita += correzione;
+}
+
+void RegolatoreStatoSpazio::inizializza(float ingresso, float uscita)
+{
+    // Ingressi e uscite passati costanti: si = somma per j >= i di (bj e + aj y)
+    double somma = 0;
+    for (size_t i = ordine; i > 0; i--)
+    {
+        somma += input_coefficients[i] * ingresso + output_coefficients[i - 1] * uscita;
+        stato[i - 1] = somma;
+    }
+    // La prossima uscita b0 e + s1 deve valere uscita; un guadagno puro (ordine 0) non ha stato da
+    // inizializzare e stato[0] resta a zero, perché calculate_output() non lo aggiornerebbe più
+    if (ordine > 0)
+    {
+        stato[0] = uscita - input_coefficients[0] * ingresso;
+    }
+    ultimoIngresso = ingresso;
+    ultimaUscita = uscita;
+}
+
+void RegolatoreStatoSpazio::setCoefficienti(const CoefficientiFissi &coefficienti, double fusione)
+{
+    input_coefficients = coefficienti.input_coeff;
+    output_coefficients = coefficienti.output_coeff;
+    size_t ordinePrecedente = ordine;
+    ordine = max(coefficienti.numeroIngresso - 1, coefficienti.numeroUscita);
+    // Gli stati oltre l'ordine precedente erano inutilizzati, quelli oltre il nuovo devono restare a zero
+    fill(stato.begin() + min(ordine, ordinePrecedente), stato.end(), 0.0);
+
+    array<double, ORDINE_MASSIMO_REGOLATORE + 1> statoPrecedente = stato;
+    inizializza(ultimoIngresso, ultimaUscita);
+    for (size_t i = 0; i < ordine; i++)
+    {
+        stato[i] = fusione * stato[i] + (1 - fusione) * statoPrecedente[i];
+    }
+}
+
+void RegolatoreStatoSpazio::setCoefficienti(const vector<double> &output_coeff, const vector<double> &input_coeff, double fusione)
+{
+    setCoefficienti(CoefficientiFissi(output_coeff, input_coeff), fusione);
+}
+
+void RegolatoreStatoSpazio::reset()
+{
+    stato.fill(0);
+    ultimoIngresso = 0;
+    ultimaUscita = 0;
+}
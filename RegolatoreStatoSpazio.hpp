@@ -0,0 +1,74 @@
+#ifndef REGOLATORE_STATO_SPAZIO_HPP
+#define REGOLATORE_STATO_SPAZIO_HPP
+
+#include <array>
+#include <cstddef>
+#include <vector>
+#include <Regolatore.hpp>
+
+// Coefficienti a dimensione fissa, nella convenzione di Regolatore: si copiano senza allocare memoria
+// e possono quindi essere passati al ciclo di controllo mentre è in esecuzione
+struct CoefficientiFissi
+{
+    std::array<double, ORDINE_MASSIMO_REGOLATORE + 1> input_coeff{};
+    std::array<double, ORDINE_MASSIMO_REGOLATORE> output_coeff{};
+    std::size_t numeroIngresso = 1;
+    std::size_t numeroUscita = 0;
+
+    CoefficientiFissi() = default;
+    CoefficientiFissi(const std::vector<double> &output_coeff, const std::vector<double> &input_coeff);
+};
+
+/*
+    Regolatore in forma di stato (forma canonica di osservabilità, equivalente alla forma diretta II trasposta)
+    con gli stessi coefficienti di Regolatore:
+
+    y[k] = b0 e[k] + s1[k]
+    si[k + 1] = bi e[k] + ai y[k] + s(i+1)[k]
+
+    A differenza di Regolatore lo stato può essere allineato a quello che succede davvero al robot:
+    - applica(): anti-windup a retro-calcolo, lo stato viene corretto con la differenza tra la velocità
+      realmente applicata (annullata ai limiti di posizione, saturata, robot in pausa) e quella calcolata.
+      Con guadagnoAntiWindup = 1 lo stato diventa quello che si avrebbe se il regolatore avesse calcolato
+      proprio la velocità applicata, con 0 il retro-calcolo è disabilitato.
+    - inizializza(): trasferimento bumpless, lo stato viene calcolato in modo che con l'errore attuale
+      l'uscita coincida con la velocità attuale del robot invece di ripartire da zero come con reset().
+    - setCoefficienti(): cambio dei parametri senza discontinuità sull'uscita, oppure con lo stato attuale
+      mantenuto o una combinazione dei due (fusione).
+*/
+class RegolatoreStatoSpazio
+{
+private:
+    std::array<double, ORDINE_MASSIMO_REGOLATORE + 1> input_coefficients{};
+    std::array<double, ORDINE_MASSIMO_REGOLATORE> output_coefficients{};
+    std::array<double, ORDINE_MASSIMO_REGOLATORE + 1> stato{}; // stato[ordine] resta sempre a zero
+    std::size_t ordine = 0;
+    double guadagnoAntiWindup;
+
+    double ultimoIngresso = 0;
+    double ultimaUscita = 0;
+
+public:
+    RegolatoreStatoSpazio(const std::vector<double> &output_coeff, const std::vector<double> &input_coeff, double guadagnoAntiWindup = 1.0);
+    RegolatoreStatoSpazio(const std::vector<float> &output_coeff, const std::vector<float> &input_coeff, double guadagnoAntiWindup = 1.0);
+
+    // Calcola l'uscita e aggiorna lo stato supponendo che venga applicata così com'è
+    float calculate_output(float input);
+
+    // Da chiamare dopo calculate_output con la velocità effettivamente inviata al robot
+    void applica(float uscitaApplicata);
+
+    // Stato di equilibrio con ingresso e uscita costanti, ma con la prossima uscita pari a uscita
+    // se l'ingresso resta quello indicato
+    void inizializza(float ingresso, float uscita);
+
+    // Nuovi coefficienti. Lo stato diventa fusione * (stato di inizializza() sugli ultimi ingresso e uscita)
+    // + (1 - fusione) * stato attuale: con fusione = 1 il cambio è bumpless, con 0 lo stato resta invariato.
+    // La versione con CoefficientiFissi non alloca e può essere chiamata dal ciclo di controllo.
+    void setCoefficienti(const CoefficientiFissi &coefficienti, double fusione = 1.0);
+    void setCoefficienti(const std::vector<double> &output_coeff, const std::vector<double> &input_coeff, double fusione = 1.0);
+
+    void reset();
+};
+
+#endif
@@ -0,0 +1,271 @@
+#include <RegolatoreTempoVariabile.hpp>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Parte immaginaria oltre la quale una radice è considerata complessa
+#define TOLLERANZA_COMPLESSA 1e-9
+
+SezioniContinue::SezioniContinue(const FunzioneTrasferimentoContinua &funzione)
+{
+    if (funzione.poli.size() > ORDINE_MASSIMO_REGOLATORE || funzione.zeri.size() > funzione.poli.size())
+    {
+        throw invalid_argument("SezioniContinue: la funzione di trasferimento deve essere propria e di ordine al massimo " + to_string(ORDINE_MASSIMO_REGOLATORE));
+    }
+
+    // Denominatori: coppie complesse e poli reali a due a due (dal più veloce), con la velocità del polo più lento
+    struct Denominatore
+    {
+        SezioneContinua sezione;
+        double lentezza;
+    };
+    vector<Denominatore> denominatori;
+    vector<double> poliReali;
+    size_t complessiPositivi = 0, complessiNegativi = 0;
+    for (const complex<double> &p : funzione.poli)
+    {
+        if (p.imag() > TOLLERANZA_COMPLESSA)
+        {
+            denominatori.push_back({{2, 0, 0, 0, norm(p), -2 * p.real()}, abs(p)});
+            complessiPositivi++;
+        }
+        else if (p.imag() < -TOLLERANZA_COMPLESSA)
+        {
+            complessiNegativi++;
+        }
+        else
+        {
+            poliReali.push_back(p.real());
+        }
+    }
+    if (complessiPositivi != complessiNegativi)
+    {
+        throw invalid_argument("SezioniContinue: i poli complessi devono essere in coppie coniugate");
+    }
+    sort(poliReali.begin(), poliReali.end(), [](double a, double b)
+         { return fabs(a) > fabs(b); });
+    for (size_t i = 0; i < poliReali.size(); i += 2)
+    {
+        if (i + 1 < poliReali.size())
+        {
+            double p1 = poliReali[i], p2 = poliReali[i + 1];
+            denominatori.push_back({{2, 0, 0, 0, p1 * p2, -(p1 + p2)}, min(fabs(p1), fabs(p2))});
+        }
+        else
+        {
+            denominatori.push_back({{1, 0, 0, 0, -poliReali[i], 0}, fabs(poliReali[i])});
+        }
+    }
+    stable_sort(denominatori.begin(), denominatori.end(), [](const Denominatore &a, const Denominatore &b)
+                { return a.lentezza > b.lentezza; });
+
+    // Numeratori: prima le coppie di zeri complessi nelle sezioni del secondo ordine, poi gli zeri reali nei posti liberi
+    vector<complex<double>> zeriComplessi;
+    vector<double> zeriReali;
+    for (const complex<double> &z : funzione.zeri)
+    {
+        if (z.imag() > TOLLERANZA_COMPLESSA)
+        {
+            zeriComplessi.push_back(z);
+        }
+        else if (fabs(z.imag()) <= TOLLERANZA_COMPLESSA)
+        {
+            zeriReali.push_back(z.real());
+        }
+    }
+    vector<bool> numeratoreComplesso(denominatori.size(), false);
+    for (size_t i = 0; i < denominatori.size() && !zeriComplessi.empty(); i++)
+    {
+        if (denominatori[i].sezione.ordine == 2)
+        {
+            complex<double> z = zeriComplessi.back();
+            zeriComplessi.pop_back();
+            SezioneContinua &s = denominatori[i].sezione;
+            s.n2 = 1;
+            s.n1 = -2 * z.real();
+            s.n0 = norm(z);
+            numeratoreComplesso[i] = true;
+        }
+    }
+    if (!zeriComplessi.empty())
+    {
+        throw invalid_argument("SezioniContinue: zeri complessi senza una sezione del secondo ordine disponibile");
+    }
+    for (size_t i = 0; i < denominatori.size(); i++)
+    {
+        SezioneContinua &s = denominatori[i].sezione;
+        if (numeratoreComplesso[i])
+        {
+            continue;
+        }
+        size_t posti = min<size_t>(s.ordine, zeriReali.size());
+        vector<double> zeri(zeriReali.end() - posti, zeriReali.end());
+        zeriReali.resize(zeriReali.size() - posti);
+        if (zeri.size() == 2)
+        {
+            s.n2 = 1;
+            s.n1 = -(zeri[0] + zeri[1]);
+            s.n0 = zeri[0] * zeri[1];
+        }
+        else if (zeri.size() == 1)
+        {
+            s.n1 = 1;
+            s.n0 = -zeri[0];
+        }
+        else
+        {
+            s.n0 = 1;
+        }
+    }
+
+    guadagno = funzione.guadagno;
+    numeroSezioni = denominatori.size();
+    for (size_t i = 0; i < numeroSezioni; i++)
+    {
+        sezioni[i] = denominatori[i].sezione;
+    }
+    if (numeroSezioni > 0)
+    {
+        sezioni[0].n0 *= guadagno;
+        sezioni[0].n1 *= guadagno;
+        sezioni[0].n2 *= guadagno;
+    }
+}
+
+RegolatoreTempoVariabile::RegolatoreTempoVariabile(const FunzioneTrasferimentoContinua &funzione, double tempoCampionamentoNominale, double guadagnoAntiWindup)
+    : sezioni(funzione), tempoCampionamentoNominale(tempoCampionamentoNominale), guadagnoAntiWindup(guadagnoAntiWindup)
+{
+    if (tempoCampionamentoNominale <= 0)
+    {
+        throw invalid_argument("RegolatoreTempoVariabile: il periodo di campionamento deve essere positivo");
+    }
+    if (guadagnoAntiWindup < 0 || guadagnoAntiWindup > 1)
+    {
+        throw invalid_argument("RegolatoreTempoVariabile: il guadagno di anti-windup deve essere compreso tra 0 e 1");
+    }
+}
+
+double RegolatoreTempoVariabile::uscita(size_t i, double ingresso) const
+{
+    const SezioneContinua &s = sezioni.sezioni[i];
+    const Stato &x = stati[i];
+    if (s.ordine == 1)
+    {
+        return (s.n0 - s.n1 * s.d0) * x.x0 + s.n1 * ingresso;
+    }
+    return (s.n0 - s.n2 * s.d0) * x.x0 + (s.n1 - s.n2 * s.d1) * x.x1 + s.n2 * ingresso;
+}
+
+float RegolatoreTempoVariabile::calculate_output(float input, double dt)
+{
+    const double h = (dt > 0) ? dt : tempoCampionamentoNominale;
+    double segnale = input;
+    if (sezioni.numeroSezioni == 0)
+    {
+        segnale *= sezioni.guadagno;
+    }
+
+    for (size_t i = 0; i < sezioni.numeroSezioni; i++)
+    {
+        const SezioneContinua &s = sezioni.sezioni[i];
+        Stato &x = stati[i];
+        // Trapezi: (I - h A / 2) x[k] = (I + h A / 2) x[k-1] + h B (v[k-1] + v[k]) / 2
+        const double mezzoPasso = h / 2;
+        const double ingressoMedio = mezzoPasso * (x.ingressoPrecedente + segnale);
+        if (s.ordine == 1)
+        {
+            x.x0 = ((1 - mezzoPasso * s.d0) * x.x0 + ingressoMedio) / (1 + mezzoPasso * s.d0);
+        }
+        else
+        {
+            // A = [0 1; -d0 -d1], B = [0; 1]
+            double r0 = x.x0 + mezzoPasso * x.x1;
+            double r1 = -mezzoPasso * s.d0 * x.x0 + (1 - mezzoPasso * s.d1) * x.x1 + ingressoMedio;
+            double m11 = 1 + mezzoPasso * s.d1;
+            double determinante = m11 + mezzoPasso * mezzoPasso * s.d0;
+            x.x0 = (m11 * r0 + mezzoPasso * r1) / determinante;
+            x.x1 = (r1 - mezzoPasso * s.d0 * r0) / determinante;
+        }
+        x.ingressoPrecedente = segnale;
+        segnale = uscita(i, segnale);
+    }
+
+    ultimoIngresso = input;
+    ultimaUscita = segnale;
+    return segnale;
+}
+
+void RegolatoreTempoVariabile::correggiUltimaSezione(double differenza)
+{
+    if (sezioni.numeroSezioni == 0)
+    {
+        return;
+    }
+    const size_t i = sezioni.numeroSezioni - 1;
+    const SezioneContinua &s = sezioni.sezioni[i];
+    double c0 = (s.ordine == 1) ? s.n0 - s.n1 * s.d0 : s.n0 - s.n2 * s.d0;
+    double c1 = (s.ordine == 1) ? 0 : s.n1 - s.n2 * s.d1;
+    double norma = c0 * c0 + c1 * c1;
+    if (norma > 0)
+    {
+        stati[i].x0 += c0 * differenza / norma;
+        stati[i].x1 += c1 * differenza / norma;
+    }
+}
+
+void RegolatoreTempoVariabile::applica(float uscitaApplicata)
+{
+    double correzione = guadagnoAntiWindup * (uscitaApplicata - ultimaUscita);
+    correggiUltimaSezione(correzione);
+    ultimaUscita += correzione;
+}
+
+void RegolatoreTempoVariabile::inizializza(float ingresso, float uscitaIniziale)
+{
+    // Ogni sezione a regime con l'ingresso costante (gli integratori partono da zero)
+    double segnale = ingresso;
+    if (sezioni.numeroSezioni == 0)
+    {
+        segnale *= sezioni.guadagno;
+    }
+    for (size_t i = 0; i < sezioni.numeroSezioni; i++)
+    {
+        const SezioneContinua &s = sezioni.sezioni[i];
+        stati[i].x0 = (s.d0 != 0) ? segnale / s.d0 : 0;
+        stati[i].x1 = 0;
+        stati[i].ingressoPrecedente = segnale;
+        segnale = uscita(i, segnale);
+    }
+    // L'ultima sezione riparte dall'uscita indicata
+    correggiUltimaSezione(uscitaIniziale - segnale);
+    ultimoIngresso = ingresso;
+    ultimaUscita = uscitaIniziale;
+}
+
+void RegolatoreTempoVariabile::setSezioni(const SezioniContinue &nuoveSezioni, double fusione)
+{
+    array<Stato, (ORDINE_MASSIMO_REGOLATORE + 1) / 2> statiPrecedenti = stati;
+    sezioni = nuoveSezioni;
+    inizializza(ultimoIngresso, ultimaUscita);
+    for (size_t i = 0; i < sezioni.numeroSezioni; i++)
+    {
+        stati[i].x0 = fusione * stati[i].x0 + (1 - fusione) * statiPrecedenti[i].x0;
+        stati[i].x1 = fusione * stati[i].x1 + (1 - fusione) * statiPrecedenti[i].x1;
+        stati[i].ingressoPrecedente = fusione * stati[i].ingressoPrecedente + (1 - fusione) * statiPrecedenti[i].ingressoPrecedente;
+    }
+    for (size_t i = sezioni.numeroSezioni; i < stati.size(); i++)
+    {
+        stati[i] = Stato();
+    }
+}
+
+void RegolatoreTempoVariabile::reset()
+{
+    stati.fill(Stato());
+    ultimoIngresso = 0;
+    ultimaUscita = 0;
+}
@@ -0,0 +1,81 @@
+#ifndef REGOLATORE_TEMPO_VARIABILE_HPP
+#define REGOLATORE_TEMPO_VARIABILE_HPP
+
+#include <array>
+#include <cstddef>
+#include <Discretizzazione.hpp>
+
+// Sezione tempo continuo del primo o del secondo ordine:
+// ordine 2: H(s) = (n2 s^2 + n1 s + n0) / (s^2 + d1 s + d0)
+// ordine 1: H(s) = (n1 s + n0) / (s + d0)
+struct SezioneContinua
+{
+    int ordine;
+    double n0, n1, n2;
+    double d0, d1;
+};
+
+// Scomposizione di H(s) in una cascata di sezioni, a dimensione fissa (si copia senza allocare)
+struct SezioniContinue
+{
+    std::array<SezioneContinua, (ORDINE_MASSIMO_REGOLATORE + 1) / 2> sezioni{};
+    std::size_t numeroSezioni = 0;
+    double guadagno = 1; // usato solo senza sezioni (regolatore proporzionale)
+
+    SezioniContinue() = default;
+    // Coppie di poli complessi e poli reali a due a due nelle sezioni del secondo ordine, un eventuale polo reale
+    // rimasto in una sezione del primo ordine; gli zeri complessi vanno nelle sezioni del secondo ordine.
+    // Le sezioni con i poli più lenti (integratori compresi) sono valutate per ultime.
+    explicit SezioniContinue(const FunzioneTrasferimentoContinua &funzione);
+};
+
+/*
+    Regolatore a periodo di campionamento variabile: ogni campione viene calcolato con il periodo effettivamente
+    trascorso dal campione precedente, invece di supporre che sia sempre quello nominale.
+
+    Lo stato è quello della realizzazione tempo continuo di ogni sezione (forma canonica di raggiungibilità), che
+    non dipende dal periodo, e viene fatto evolvere con la regola dei trapezi: per un periodo costante è identico
+    alla discretizzazione di Tustin (DISCRETIZZAZIONE_TUSTIN senza prewarp), ma con periodi diversi l'azione
+    integrale e le costanti di tempo restano scalate correttamente. Per ogni campione, oltre ai coefficienti
+    precalcolati delle sezioni, servono solo pochi prodotti e una divisione per sezione.
+
+    Come RegolatoreStatoSpazio offre anti-windup (applica) e ripartenza bumpless (inizializza); la correzione
+    dello stato è applicata all'ultima sezione, che contiene gli eventuali integratori.
+*/
+class RegolatoreTempoVariabile
+{
+private:
+    struct Stato
+    {
+        double x0 = 0, x1 = 0;
+        double ingressoPrecedente = 0;
+    };
+
+    SezioniContinue sezioni;
+    std::array<Stato, (ORDINE_MASSIMO_REGOLATORE + 1) / 2> stati{};
+    double tempoCampionamentoNominale;
+    double guadagnoAntiWindup;
+    double ultimoIngresso = 0;
+    double ultimaUscita = 0;
+
+    // Uscita della sezione i con lo stato attuale e l'ingresso indicato
+    double uscita(std::size_t i, double ingresso) const;
+    // Porta l'uscita dell'ultima sezione al valore indicato con la minima correzione dello stato
+    void correggiUltimaSezione(double differenza);
+
+public:
+    RegolatoreTempoVariabile(const FunzioneTrasferimentoContinua &funzione, double tempoCampionamentoNominale, double guadagnoAntiWindup = 1.0);
+
+    // Campione calcolato dopo dt secondi dal precedente
+    float calculate_output(float input, double dt);
+    // Campione dopo il periodo nominale
+    float calculate_output(float input) { return calculate_output(input, tempoCampionamentoNominale); }
+
+    void applica(float uscitaApplicata);
+    void inizializza(float ingresso, float uscita);
+    // Nuove sezioni senza allocare: fusione come in RegolatoreStatoSpazio::setCoefficienti
+    void setSezioni(const SezioniContinue &nuoveSezioni, double fusione = 1.0);
+    void reset();
+};
+
+#endif
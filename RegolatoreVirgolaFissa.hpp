@@ -0,0 +1,176 @@
+#ifndef REGOLATORE_VIRGOLA_FISSA_HPP
+#define REGOLATORE_VIRGOLA_FISSA_HPP
+
+#include <RegolatoreFisso.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Fondi scala di default per il ciclo di controllo: errore in mm (portata del sensore 200 mm)
+// e velocità in mm/s (il Meca500 accetta velocità tra -1000 e 1000 mm/s)
+#define FONDO_SCALA_INGRESSO_DEFAULT 512.0f
+#define FONDO_SCALA_USCITA_DEFAULT 1024.0f
+
+// Formato Q: valori frazionari in [-1, 1) rappresentati con BitFrazionari bit dopo la virgola
+template <typename Campione, int BitFrazionari>
+struct FormatoQ
+{
+    using campione = Campione;
+    static constexpr int FRAZIONE = BitFrazionari;
+    static constexpr int64_t MASSIMO = std::numeric_limits<Campione>::max();
+    static constexpr int64_t MINIMO = std::numeric_limits<Campione>::min();
+    // I prodotti Q15 x Q15 (Q30) si accumulano senza perdita a 64 bit; quelli Q31 x Q31 vengono
+    // riportati a Q31 prima dell'accumulo per lasciare spazio alla somma anche su ARM a 32 bit
+    static constexpr int SCORRIMENTO_PRODOTTO = (BitFrazionari > 16) ? BitFrazionari : 0;
+    static constexpr int FRAZIONE_ACCUMULATORE = 2 * BitFrazionari - SCORRIMENTO_PRODOTTO;
+
+    static Campione satura(int64_t x)
+    {
+        return (Campione)std::clamp<int64_t>(x, MINIMO, MASSIMO);
+    }
+
+    static Campione daFloat(float x)
+    {
+        return satura((int64_t)std::llround((double)x * (double)(1LL << FRAZIONE)));
+    }
+
+    static float aFloat(Campione x)
+    {
+        return (float)x / (float)(1LL << FRAZIONE);
+    }
+};
+
+using Q15 = FormatoQ<int16_t, 15>;
+using Q31 = FormatoQ<int32_t, 31>;
+
+// Scorrimento aritmetico con arrotondamento al più vicino: a destra per n > 0, a sinistra (con saturazione) per n < 0
+inline int64_t scorriArrotondando(int64_t x, int n)
+{
+    if (n > 0)
+    {
+        return (x + (1LL << (n - 1))) >> n;
+    }
+    if (n < 0)
+    {
+        const int64_t limite = std::numeric_limits<int64_t>::max() >> -n;
+        return (x > limite) ? std::numeric_limits<int64_t>::max() : (x < -limite) ? std::numeric_limits<int64_t>::min() : x * (1LL << -n);
+    }
+    return x;
+}
+
+/*
+    Regolatore tempo discreto in aritmetica intera a virgola fissa (Q15 o Q31) con saturazione:
+
+    y[k] = b[0] * u[k] + ... + b[NumOrder] * u[k - NumOrder] + a[0] * y[k - 1] + ... + a[DenOrder - 1] * y[k - DenOrder]
+
+    Ingresso e uscita sono normalizzati dai rispettivi fondi scala; i coefficienti normalizzati vengono
+    scalati automaticamente di 2^-SCALA così da essere rappresentabili nel formato scelto e il fattore
+    2^SCALA è recuperato con uno scorrimento sull'accumulatore a 64 bit. L'uscita è saturata al fondo scala,
+    quindi lo stato non va mai in overflow.
+*/
+template <std::size_t NumOrder, std::size_t DenOrder, typename Formato = Q15>
+class RegolatoreVirgolaFissa
+{
+public:
+    using campione = typename Formato::campione;
+    static constexpr std::size_t NUM_COEFFICIENTI_INGRESSO = NumOrder + 1;
+    static constexpr std::size_t NUM_COEFFICIENTI_USCITA = DenOrder;
+
+private:
+    std::array<campione, NUM_COEFFICIENTI_INGRESSO> input_coefficients{};
+    std::array<campione, NUM_COEFFICIENTI_USCITA> output_coefficients{};
+    BufferCircolare<NUM_COEFFICIENTI_INGRESSO, campione> previous_inputs;
+    BufferCircolare<NUM_COEFFICIENTI_USCITA, campione> previous_outputs;
+    int scala = 0;                 // esponente del fattore di scala dei coefficienti
+    float fondoScalaIngresso;
+    float fondoScalaUscita;
+
+    template <std::size_t... I>
+    static int64_t sommaProdotti(const campione *coefficienti, const campione *campioni, std::index_sequence<I...>)
+    {
+        return ((((int64_t)coefficienti[I] * campioni[I]) >> Formato::SCORRIMENTO_PRODOTTO) + ... + 0);
+    }
+
+public:
+    RegolatoreVirgolaFissa(const std::vector<float> &output_coeff, const std::vector<float> &input_coeff,
+                           float fondoScalaIngresso = FONDO_SCALA_INGRESSO_DEFAULT, float fondoScalaUscita = FONDO_SCALA_USCITA_DEFAULT)
+        : fondoScalaIngresso(fondoScalaIngresso), fondoScalaUscita(fondoScalaUscita)
+    {
+        if (input_coeff.size() > NUM_COEFFICIENTI_INGRESSO || output_coeff.size() > NUM_COEFFICIENTI_USCITA)
+        {
+            throw std::invalid_argument("RegolatoreVirgolaFissa: ordine non supportato");
+        }
+
+        // Coefficienti riferiti a ingresso e uscita normalizzati
+        std::vector<double> ingresso(input_coeff.begin(), input_coeff.end());
+        std::vector<double> uscita(output_coeff.begin(), output_coeff.end());
+        double massimo = 0;
+        for (double &c : ingresso)
+        {
+            c *= (double)fondoScalaIngresso / fondoScalaUscita;
+            massimo = std::max(massimo, std::fabs(c));
+        }
+        for (double c : uscita)
+        {
+            massimo = std::max(massimo, std::fabs(c));
+        }
+
+        // Minima scala che rende tutti i coefficienti rappresentabili in [-1, 1)
+        const double limite = 1.0 - 1.0 / (double)(1LL << Formato::FRAZIONE);
+        while (massimo / (double)(1LL << scala) > limite)
+        {
+            scala++;
+        }
+
+        for (std::size_t i = 0; i < ingresso.size(); i++)
+        {
+            input_coefficients[i] = Formato::daFloat(ingresso[i] / (double)(1LL << scala));
+        }
+        for (std::size_t i = 0; i < uscita.size(); i++)
+        {
+            output_coefficients[i] = Formato::daFloat(uscita[i] / (double)(1LL << scala));
+        }
+    }
+
+    // Passo del regolatore su campioni già normalizzati nel formato Q
+    campione calculate_output_q(campione input)
+    {
+        previous_inputs.inserisci(input);
+
+        int64_t accumulatore = sommaProdotti(input_coefficients.data(), previous_inputs.finestra(),
+                                             std::make_index_sequence<NUM_COEFFICIENTI_INGRESSO>{});
+        if constexpr (NUM_COEFFICIENTI_USCITA > 0)
+        {
+            accumulatore += sommaProdotti(output_coefficients.data(), previous_outputs.finestra(),
+                                          std::make_index_sequence<NUM_COEFFICIENTI_USCITA>{});
+        }
+
+        // Riporta l'accumulatore nel formato Q recuperando il fattore 2^scala, con saturazione
+        campione output = Formato::satura(scorriArrotondando(accumulatore, Formato::FRAZIONE_ACCUMULATORE - Formato::FRAZIONE - scala));
+        previous_outputs.inserisci(output);
+        return output;
+    }
+
+    // Stessa interfaccia di Regolatore: errore in mm, velocità in mm/s
+    float calculate_output(float input)
+    {
+        campione output = calculate_output_q(Formato::daFloat(input / fondoScalaIngresso));
+        return Formato::aFloat(output) * fondoScalaUscita;
+    }
+
+    // Resetta tutte le variabili di stato a 0
+    void reset()
+    {
+        previous_inputs.azzera();
+        previous_outputs.azzera();
+    }
+
+    int getScala() const { return scala; }
+};
+
+#endif
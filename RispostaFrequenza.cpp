@@ -0,0 +1,199 @@
+#include <RispostaFrequenza.hpp>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+using namespace std;
+
+namespace
+{
+    // Elemento i di un vettore memorizzato a blocchi di registri
+    float elemento(const vector<VettoreSimd> &blocchi, size_t i)
+    {
+        alignas(ALLINEAMENTO_SIMD) float valori[VettoreSimd::LARGHEZZA];
+        blocchi[i / VettoreSimd::LARGHEZZA].salva(valori);
+        return valori[i % VettoreSimd::LARGHEZZA];
+    }
+
+    double gradi(double radianti) { return radianti * 180 / M_PI; }
+}
+
+RispostaFrequenza::RispostaFrequenza(const ParametriMeca500 &impianto, double tempoCampionamento, size_t numeroPunti, double pulsazioneMinima)
+    : numeroPunti(numeroPunti)
+{
+    const double pulsazioneNyquist = M_PI / tempoCampionamento;
+    if (numeroPunti < 2 || !(pulsazioneMinima > 0) || pulsazioneMinima >= pulsazioneNyquist)
+    {
+        throw invalid_argument("RispostaFrequenza: servono almeno due punti tra una pulsazione positiva e quella di Nyquist");
+    }
+    numeroBlocchi = arrotondaLarghezzaSimd(numeroPunti) / VettoreSimd::LARGHEZZA;
+    const size_t numeroPotenze = ORDINE_MASSIMO_REGOLATORE + 1;
+    coseni.resize(numeroPotenze * numeroBlocchi);
+    seni.resize(numeroPotenze * numeroBlocchi);
+    impiantoReale.resize(numeroBlocchi);
+    impiantoImmaginario.resize(numeroBlocchi);
+    anelloReale.resize(numeroBlocchi);
+    anelloImmaginario.resize(numeroBlocchi);
+    regolatoreReale.resize(numeroBlocchi);
+    regolatoreImmaginario.resize(numeroBlocchi);
+
+    // Griglia logaritmica; i posti oltre numeroPunti nell'ultimo blocco ripetono l'ultima pulsazione
+    ModelloMeca500 modello(impianto, tempoCampionamento, 0);
+    const double rapporto = log(pulsazioneNyquist / pulsazioneMinima) / (numeroPunti - 1);
+    alignas(ALLINEAMENTO_SIMD) float valori[VettoreSimd::LARGHEZZA];
+    for (size_t b = 0; b < numeroBlocchi; b++)
+    {
+        for (size_t k = 0; k < numeroPotenze; k++)
+        {
+            for (size_t l = 0; l < VettoreSimd::LARGHEZZA; l++)
+            {
+                size_t i = min(b * VettoreSimd::LARGHEZZA + l, numeroPunti - 1);
+                valori[l] = (float)cos(k * pulsazioneMinima * exp(rapporto * i) * tempoCampionamento);
+            }
+            coseni[k * numeroBlocchi + b] = VettoreSimd::carica(valori);
+            for (size_t l = 0; l < VettoreSimd::LARGHEZZA; l++)
+            {
+                size_t i = min(b * VettoreSimd::LARGHEZZA + l, numeroPunti - 1);
+                valori[l] = (float)sin(k * pulsazioneMinima * exp(rapporto * i) * tempoCampionamento);
+            }
+            seni[k * numeroBlocchi + b] = VettoreSimd::carica(valori);
+        }
+    }
+
+    vector<complex<double>> risposta(numeroBlocchi * VettoreSimd::LARGHEZZA);
+    for (size_t i = 0; i < risposta.size(); i++)
+    {
+        double pulsazione = pulsazioneMinima * exp(rapporto * min(i, numeroPunti - 1));
+        risposta[i] = modello.rispostaInFrequenza(pulsazione);
+        if (i < numeroPunti)
+        {
+            pulsazioni.push_back(pulsazione);
+            // Fase resa continua: il salto rispetto al punto precedente è sempre minore di mezzo giro
+            double fase = gradi(arg(risposta[i]));
+            if (i > 0)
+            {
+                fase += 360 * round((faseImpianto.back() - fase) / 360);
+            }
+            faseImpianto.push_back(fase);
+        }
+    }
+    for (size_t b = 0; b < numeroBlocchi; b++)
+    {
+        for (size_t l = 0; l < VettoreSimd::LARGHEZZA; l++)
+            valori[l] = (float)risposta[b * VettoreSimd::LARGHEZZA + l].real();
+        impiantoReale[b] = VettoreSimd::carica(valori);
+        for (size_t l = 0; l < VettoreSimd::LARGHEZZA; l++)
+            valori[l] = (float)risposta[b * VettoreSimd::LARGHEZZA + l].imag();
+        impiantoImmaginario[b] = VettoreSimd::carica(valori);
+    }
+}
+
+void RispostaFrequenza::valutaAnello(const double *output_coeff, size_t numeroUscita, const double *input_coeff, size_t numeroIngresso)
+{
+    if (numeroIngresso == 0 || numeroIngresso > ORDINE_MASSIMO_REGOLATORE + 1 || numeroUscita > ORDINE_MASSIMO_REGOLATORE)
+    {
+        throw invalid_argument("RispostaFrequenza: ordine del regolatore non supportato");
+    }
+    for (size_t b = 0; b < numeroBlocchi; b++)
+    {
+        // Numeratore b0 + b1 z^-1 + ... e denominatore 1 - a1 z^-1 - ..., con z^-k = cos(k w Tc) - j sin(k w Tc)
+        VettoreSimd numeratoreReale = VettoreSimd::zero(), numeratoreImmaginario = VettoreSimd::zero();
+        for (size_t k = 0; k < numeroIngresso; k++)
+        {
+            VettoreSimd c = VettoreSimd::costante((float)input_coeff[k]);
+            numeratoreReale = numeratoreReale + c * coseni[k * numeroBlocchi + b];
+            numeratoreImmaginario = numeratoreImmaginario - c * seni[k * numeroBlocchi + b];
+        }
+        VettoreSimd denominatoreReale = VettoreSimd::costante(1), denominatoreImmaginario = VettoreSimd::zero();
+        for (size_t k = 0; k < numeroUscita; k++)
+        {
+            VettoreSimd c = VettoreSimd::costante((float)output_coeff[k]);
+            denominatoreReale = denominatoreReale - c * coseni[(k + 1) * numeroBlocchi + b];
+            denominatoreImmaginario = denominatoreImmaginario + c * seni[(k + 1) * numeroBlocchi + b];
+        }
+
+        // R = N conj(D) / |D|^2, L = R G
+        VettoreSimd modulo = denominatoreReale * denominatoreReale + denominatoreImmaginario * denominatoreImmaginario;
+        VettoreSimd rRe = (numeratoreReale * denominatoreReale + numeratoreImmaginario * denominatoreImmaginario) / modulo;
+        VettoreSimd rIm = (numeratoreImmaginario * denominatoreReale - numeratoreReale * denominatoreImmaginario) / modulo;
+        regolatoreReale[b] = rRe;
+        regolatoreImmaginario[b] = rIm;
+        anelloReale[b] = rRe * impiantoReale[b] - rIm * impiantoImmaginario[b];
+        anelloImmaginario[b] = rRe * impiantoImmaginario[b] + rIm * impiantoReale[b];
+    }
+}
+
+MarginiStabilita RispostaFrequenza::margini(const double *output_coeff, size_t numeroUscita, const double *input_coeff, size_t numeroIngresso)
+{
+    valutaAnello(output_coeff, numeroUscita, input_coeff, numeroIngresso);
+
+    MarginiStabilita risultato{NAN, NAN, NAN, numeric_limits<double>::infinity(), 0, NAN};
+    double minimoRitornoQuadro = numeric_limits<double>::infinity();
+    double realePrecedente = 0, immaginarioPrecedente = 0, moduloQuadroPrecedente = 0, fasePrecedente = 0;
+    alignas(ALLINEAMENTO_SIMD) float reali[VettoreSimd::LARGHEZZA];
+    alignas(ALLINEAMENTO_SIMD) float immaginari[VettoreSimd::LARGHEZZA];
+    for (size_t b = 0; b < numeroBlocchi; b++)
+    {
+        anelloReale[b].salva(reali);
+        anelloImmaginario[b].salva(immaginari);
+        for (size_t l = 0; l < VettoreSimd::LARGHEZZA && b * VettoreSimd::LARGHEZZA + l < numeroPunti; l++)
+        {
+            const size_t i = b * VettoreSimd::LARGHEZZA + l;
+            const double reale = reali[l], immaginario = immaginari[l];
+            const double moduloQuadro = reale * reale + immaginario * immaginario;
+
+            // Fase di L resa continua lungo tutta la griglia, con il ramo del primo punto fissato dalla somma delle fasi
+            // di regolatore e impianto: sommare la fase principale del regolatore a quella continua dell'impianto
+            // sbaglia di un giro quando è la fase del regolatore a passare per ±180 gradi
+            double fase = gradi(atan2(immaginario, reale));
+            double faseRiferimento = (i == 0) ? gradi(arg(getRegolatore(0))) + faseImpianto[0] : fasePrecedente;
+            fase += 360 * round((faseRiferimento - fase) / 360);
+
+            // Sensibilità 1 / |1 + L|: basta il minimo della distanza dal punto critico
+            const double ritornoQuadro = (1 + reale) * (1 + reale) + immaginario * immaginario;
+            if (ritornoQuadro < minimoRitornoQuadro)
+            {
+                minimoRitornoQuadro = ritornoQuadro;
+                risultato.pulsazionePiccoSensibilita = pulsazioni[i];
+            }
+
+            if (i > 0 && std::isnan(risultato.pulsazioneAttraversamento) && moduloQuadroPrecedente >= 1 && moduloQuadro < 1)
+            {
+                // Interpolazione lineare di log |L| rispetto a log w
+                double t = log(moduloQuadroPrecedente) / (log(moduloQuadroPrecedente) - log(moduloQuadro));
+                risultato.pulsazioneAttraversamento = pulsazioni[i - 1] * pow(pulsazioni[i] / pulsazioni[i - 1], t);
+                risultato.margineFase = 180 + fasePrecedente + t * (fase - fasePrecedente);
+            }
+            if (i > 0 && std::isnan(risultato.pulsazioneInversioneFase) && reale < 0 && realePrecedente < 0 &&
+                (immaginario < 0) != (immaginarioPrecedente < 0))
+            {
+                double t = immaginarioPrecedente / (immaginarioPrecedente - immaginario);
+                risultato.pulsazioneInversioneFase = pulsazioni[i - 1] * pow(pulsazioni[i] / pulsazioni[i - 1], t);
+                double modulo = sqrt(moduloQuadroPrecedente) + t * (sqrt(moduloQuadro) - sqrt(moduloQuadroPrecedente));
+                risultato.margineGuadagno = -20 * log10(modulo);
+            }
+
+            realePrecedente = reale;
+            immaginarioPrecedente = immaginario;
+            moduloQuadroPrecedente = moduloQuadro;
+            fasePrecedente = fase;
+        }
+    }
+    risultato.piccoSensibilita = 1 / sqrt(minimoRitornoQuadro);
+    return risultato;
+}
+
+complex<double> RispostaFrequenza::getRegolatore(size_t i) const
+{
+    return {elemento(regolatoreReale, i), elemento(regolatoreImmaginario, i)};
+}
+
+complex<double> RispostaFrequenza::getImpianto(size_t i) const
+{
+    return {elemento(impiantoReale, i), elemento(impiantoImmaginario, i)};
+}
+
+complex<double> RispostaFrequenza::getAnelloAperto(size_t i) const
+{
+    return {elemento(anelloReale, i), elemento(anelloImmaginario, i)};
+}
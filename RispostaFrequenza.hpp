@@ -0,0 +1,79 @@
+#ifndef RISPOSTA_FREQUENZA_HPP
+#define RISPOSTA_FREQUENZA_HPP
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+#include <ModelloMeca500.hpp>
+#include <ProgettoRegolatore.hpp>
+#include <RegolatoreStatoSpazio.hpp>
+#include <VettoreSimd.hpp>
+
+// Numero di pulsazioni di default, da 0.1 rad/s alla frequenza di Nyquist
+#define PUNTI_RISPOSTA_FREQUENZA_DEFAULT 1024
+#define PULSAZIONE_MINIMA_DEFAULT 0.1
+
+// Indici di robustezza dell'anello aperto L = R G (pulsazioni in rad/s, NAN se l'attraversamento non esiste)
+struct MarginiStabilita
+{
+    double pulsazioneAttraversamento;     // |L| = 1, primo attraversamento verso il basso
+    double margineFase;                   // gradi, 180 + fase di L all'attraversamento
+    double pulsazioneInversioneFase;      // fase di L = -180 gradi, primo attraversamento del semiasse reale negativo
+    double margineGuadagno;               // dB, -20 log10 |L| all'inversione di fase (infinito se non c'è)
+    double piccoSensibilita;              // Ms = massimo di |1 / (1 + L)| sulla griglia
+    double pulsazionePiccoSensibilita;
+};
+
+/*
+    Risposta in frequenza del regolatore R(e^(j w Tc)), dell'impianto G (modello esatto del Meca500) e
+    dell'anello aperto L = R G su una griglia logaritmica di pulsazioni, con i margini di stabilità.
+
+    Tutto quello che non dipende dal regolatore è calcolato una volta nel costruttore: le potenze
+    z^-k = cos(k w Tc) - j sin(k w Tc) e G per ogni pulsazione, in blocchi della larghezza dei registri
+    (struttura di array, come RegolatoreBank). La valutazione di un regolatore è quindi fatta di prodotti
+    scalari complessi vettoriali (VettoreSimd) su tutte le pulsazioni insieme e di una sola scansione
+    scalare per gli attraversamenti, senza allocazioni: può essere chiamata milioni di volte in una ricerca
+    sullo spazio dei progetti, con un oggetto per thread. Nella scansione c'è un atan2 per pulsazione, perché la
+    fase di L va seguita punto per punto per restare sul ramo giusto anche dopo più giri (ritardo dell'impianto).
+*/
+class RispostaFrequenza
+{
+private:
+    std::size_t numeroPunti;
+    std::size_t numeroBlocchi;
+    std::vector<double> pulsazioni;
+    std::vector<double> faseImpianto; // fase di G in gradi, continua lungo la griglia
+
+    // [k * numeroBlocchi + b]: cos e sin di k w Tc per le pulsazioni del blocco b, k = 0 ... ORDINE_MASSIMO_REGOLATORE
+    std::vector<VettoreSimd> coseni, seni;
+    std::vector<VettoreSimd> impiantoReale, impiantoImmaginario;
+    // Ultimo anello aperto valutato
+    std::vector<VettoreSimd> anelloReale, anelloImmaginario, regolatoreReale, regolatoreImmaginario;
+
+    void valutaAnello(const double *output_coeff, std::size_t numeroUscita, const double *input_coeff, std::size_t numeroIngresso);
+
+public:
+    RispostaFrequenza(const ParametriMeca500 &impianto, double tempoCampionamento,
+                      std::size_t numeroPunti = PUNTI_RISPOSTA_FREQUENZA_DEFAULT, double pulsazioneMinima = PULSAZIONE_MINIMA_DEFAULT);
+
+    // Margini del regolatore con i coefficienti nella convenzione di Regolatore (ordine al massimo ORDINE_MASSIMO_REGOLATORE)
+    MarginiStabilita margini(const double *output_coeff, std::size_t numeroUscita, const double *input_coeff, std::size_t numeroIngresso);
+    MarginiStabilita margini(const CoefficientiFissi &coefficienti)
+    {
+        return margini(coefficienti.output_coeff.data(), coefficienti.numeroUscita, coefficienti.input_coeff.data(), coefficienti.numeroIngresso);
+    }
+    template <std::size_t NumZeri, std::size_t NumPoli>
+    MarginiStabilita margini(const ProgettoRegolatore<NumZeri, NumPoli> &progetto)
+    {
+        return margini(progetto.output_coeff.data(), NumPoli, progetto.input_coeff.data(), NumZeri + 1);
+    }
+
+    // Risposte dell'ultimo regolatore passato a margini(), per il punto i della griglia
+    std::size_t getNumeroPunti() const { return numeroPunti; }
+    double getPulsazione(std::size_t i) const { return pulsazioni[i]; }
+    std::complex<double> getRegolatore(std::size_t i) const;
+    std::complex<double> getImpianto(std::size_t i) const;
+    std::complex<double> getAnelloAperto(std::size_t i) const;
+};
+
+#endif
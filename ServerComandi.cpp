@@ -0,0 +1,235 @@
+#include <ServerComandi.hpp>
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace
+{
+    // Scrive tutta la risposta; un client che non legge viene perso, non blocca il server
+    bool scriviTutto(int descrittore, const string &testo)
+    {
+        size_t scritti = 0;
+        while (scritti < testo.size())
+        {
+            ssize_t n = (descrittore == STDOUT_FILENO) ? write(descrittore, testo.data() + scritti, testo.size() - scritti)
+                                                       : send(descrittore, testo.data() + scritti, testo.size() - scritti, MSG_NOSIGNAL | MSG_DONTWAIT);
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                return false;
+            }
+            scritti += n;
+        }
+        return true;
+    }
+
+    // Un socket con un server in ascolto accetta la connessione; quello di un processo terminato la rifiuta
+    bool socketAttivo(const sockaddr_un &indirizzo)
+    {
+        int prova = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (prova < 0)
+        {
+            throw runtime_error("ServerComandi: impossibile creare il socket: " + string(strerror(errno)));
+        }
+        int esito = connect(prova, (const sockaddr *)&indirizzo, sizeof(indirizzo));
+        int errore = errno;
+        close(prova);
+        if (esito == 0)
+        {
+            return true;
+        }
+        if (errore == ECONNREFUSED)
+        {
+            return false;
+        }
+        // Permessi o altro: nel dubbio il socket non è rimosso
+        throw runtime_error("ServerComandi: impossibile verificare " + string(indirizzo.sun_path) + ": " + strerror(errore));
+    }
+}
+
+ServerComandi::ServerComandi(const string &percorsoSocket, bool usaStdin) : percorso(percorsoSocket), stdinAperto(usaStdin)
+{
+    if (percorso.empty())
+    {
+        return;
+    }
+
+    sockaddr_un indirizzo = {};
+    indirizzo.sun_family = AF_UNIX;
+    if (percorso.size() >= sizeof(indirizzo.sun_path))
+    {
+        throw invalid_argument("ServerComandi: percorso del socket troppo lungo");
+    }
+    strcpy(indirizzo.sun_path, percorso.c_str());
+
+    ascolto = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (ascolto < 0)
+    {
+        throw runtime_error("ServerComandi: impossibile creare il socket: " + string(strerror(errno)));
+    }
+
+    // Rimuove solo un socket rimasto da un'esecuzione interrotta, mai quello di un'altra istanza attiva
+    struct stat info;
+    if (lstat(percorso.c_str(), &info) == 0)
+    {
+        if (!S_ISSOCK(info.st_mode))
+        {
+            close(ascolto);
+            throw runtime_error("ServerComandi: " + percorso + " esiste e non è un socket");
+        }
+        if (socketAttivo(indirizzo))
+        {
+            close(ascolto);
+            throw runtime_error("ServerComandi: un altro processo ascolta già su " + percorso);
+        }
+        unlink(percorso.c_str());
+    }
+
+    // Solo il proprietario può connettersi (i comandi muovono il robot): i permessi sono impostati prima di
+    // listen(), quindi nessun client può connettersi prima
+    if (bind(ascolto, (sockaddr *)&indirizzo, sizeof(indirizzo)) < 0)
+    {
+        string errore = strerror(errno);
+        close(ascolto);
+        throw runtime_error("ServerComandi: impossibile ascoltare su " + percorso + ": " + errore);
+    }
+    if (chmod(percorso.c_str(), S_IRUSR | S_IWUSR) < 0 || listen(ascolto, CLIENT_MASSIMI) < 0)
+    {
+        string errore = strerror(errno);
+        close(ascolto);
+        unlink(percorso.c_str());
+        throw runtime_error("ServerComandi: impossibile ascoltare su " + percorso + ": " + errore);
+    }
+}
+
+ServerComandi::~ServerComandi()
+{
+    for (Client &client : clients)
+    {
+        close(client.descrittore);
+    }
+    if (ascolto >= 0)
+    {
+        close(ascolto);
+        unlink(percorso.c_str());
+    }
+}
+
+bool ServerComandi::eseguiRighe(string &buffer, int risposta, const Esecutore &esegui)
+{
+    size_t inizio = 0, fine;
+    while ((fine = buffer.find('\n', inizio)) != string::npos)
+    {
+        string riga = buffer.substr(inizio, fine - inizio);
+        if (!riga.empty() && riga.back() == '\r')
+        {
+            riga.pop_back();
+        }
+        inizio = fine + 1;
+        if (!scriviTutto(risposta, esegui(riga)))
+        {
+            return false;
+        }
+    }
+    buffer.erase(0, inizio);
+    return buffer.size() <= LUNGHEZZA_MASSIMA_RIGA;
+}
+
+void ServerComandi::servi(int timeoutMillisecondi, const Esecutore &esegui)
+{
+    // Descrittori nell'ordine: stdin (se aperto), socket di ascolto (se presente), client
+    pollfd descrittori[2 + CLIENT_MASSIMI];
+    nfds_t numero = 0;
+    if (stdinAperto)
+    {
+        descrittori[numero++] = {STDIN_FILENO, POLLIN, 0};
+    }
+    if (ascolto >= 0 && clients.size() < CLIENT_MASSIMI)
+    {
+        descrittori[numero++] = {ascolto, POLLIN, 0};
+    }
+    nfds_t primoClient = numero;
+    for (const Client &client : clients)
+    {
+        descrittori[numero++] = {client.descrittore, POLLIN, 0};
+    }
+
+    if (poll(descrittori, numero, timeoutMillisecondi) <= 0)
+    {
+        return;
+    }
+
+    char blocco[1024];
+    for (nfds_t i = 0; i < primoClient; i++)
+    {
+        if (!descrittori[i].revents)
+        {
+            continue;
+        }
+        if (descrittori[i].fd == STDIN_FILENO)
+        {
+            ssize_t n = read(STDIN_FILENO, blocco, sizeof(blocco));
+            if (n <= 0 && !(n < 0 && errno == EINTR))
+            {
+                stdinAperto = false;
+                continue;
+            }
+            bufferStdin.append(blocco, n > 0 ? n : 0);
+            if (!eseguiRighe(bufferStdin, STDOUT_FILENO, esegui))
+            {
+                bufferStdin.clear();
+            }
+        }
+        else
+        {
+            int nuovo = accept4(ascolto, nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK);
+            if (nuovo >= 0)
+            {
+                clients.push_back({nuovo, string()});
+            }
+        }
+    }
+
+    // I client accettati in questa chiamata non sono in descrittori: sono letti alla successiva
+    vector<int> chiusi;
+    for (nfds_t i = primoClient; i < numero; i++)
+    {
+        if (!descrittori[i].revents)
+        {
+            continue;
+        }
+        Client &client = clients[i - primoClient];
+        ssize_t n = recv(client.descrittore, blocco, sizeof(blocco), 0);
+        if (n < 0 && (errno == EINTR || errno == EAGAIN))
+        {
+            continue;
+        }
+        client.buffer.append(blocco, n > 0 ? n : 0);
+        if (n <= 0 || !eseguiRighe(client.buffer, client.descrittore, esegui))
+        {
+            chiusi.push_back(client.descrittore);
+        }
+    }
+    for (int descrittore : chiusi)
+    {
+        close(descrittore);
+        for (size_t i = 0; i < clients.size(); i++)
+        {
+            if (clients[i].descrittore == descrittore)
+            {
+                clients.erase(clients.begin() + i);
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef SERVER_COMANDI_HPP
+#define SERVER_COMANDI_HPP
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+/*
+    Ricezione dei comandi testuali da stdin e da un socket UNIX locale, in un solo thread.
+
+    servi() attende con poll() righe complete dall'ingresso standard e dai client connessi al socket (per
+    esempio `socat - UNIX-CONNECT:<percorso>` o uno script), esegue ogni riga con la funzione data e invia la
+    risposta a chi l'ha mandata: su stdout per stdin, sul socket per i client. Con il timeout servi() ritorna
+    anche senza comandi, così il thread che lo chiama in ciclo può controllare quando fermarsi.
+
+    Le righe più lunghe di LUNGHEZZA_MASSIMA_RIGA chiudono il client che le invia; la fine di stdin (programma
+    avviato senza terminale) esclude solo stdin. Il socket ha permessi 0600 (solo l'utente che avvia il
+    programma può inviare comandi) ed è rimosso alla distruzione. Il costruttore lancia runtime_error se il
+    percorso è di un'altra istanza in ascolto o non è un socket; un socket rimasto da un'esecuzione interrotta
+    è sostituito.
+*/
+class ServerComandi
+{
+public:
+    // Esegue una riga di comando e ritorna la risposta da inviare
+    using Esecutore = std::function<std::string(const std::string &)>;
+
+    static constexpr std::size_t LUNGHEZZA_MASSIMA_RIGA = 4096;
+    static constexpr std::size_t CLIENT_MASSIMI = 8;
+
+private:
+    struct Client
+    {
+        int descrittore;
+        std::string buffer; // caratteri ricevuti dopo l'ultima riga completa
+    };
+
+    std::string percorso;
+    int ascolto = -1;
+    bool stdinAperto;
+    std::string bufferStdin;
+    std::vector<Client> clients;
+
+    // Esegue le righe complete in buffer; false se la riga in corso è troppo lunga
+    bool eseguiRighe(std::string &buffer, int risposta, const Esecutore &esegui);
+
+public:
+    // percorsoSocket vuoto: solo stdin
+    explicit ServerComandi(const std::string &percorsoSocket, bool usaStdin = true);
+    ~ServerComandi();
+
+    ServerComandi(const ServerComandi &) = delete;
+    ServerComandi &operator=(const ServerComandi &) = delete;
+
+    // Attende al più timeoutMillisecondi ed esegue le righe arrivate nel frattempo
+    void servi(int timeoutMillisecondi, const Esecutore &esegui);
+};
+
+#endif
@@ -0,0 +1,165 @@
+#include <SezioniSecondoOrdine.hpp>
+#include <Polinomi.hpp>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <limits>
+
+using namespace std;
+
+// Tolleranza relativa sulla parte immaginaria per considerare reale una radice
+#define TOLLERANZA_RADICE_REALE 1e-6
+
+namespace
+{
+    // Gruppo di una o due radici che forma il numeratore o il denominatore di una sezione
+    struct Gruppo
+    {
+        double coefficienti[3];      // polinomio in z^-1 del gruppo
+        complex<double> posizione;   // radice rappresentativa, usata per l'accoppiamento
+        bool infinito;               // gruppo composto solo da zeri all'infinito (ritardi puri)
+    };
+
+    // Prodotto di fattori del primo ordine in z^-1: (1 - r z^-1) per una radice finita, z^-1 per uno zero all'infinito
+    struct Fattore
+    {
+        double c0, c1;
+        double raggio;
+        bool infinito;
+    };
+
+    Gruppo coppia(const Fattore &f1, const Fattore &f2)
+    {
+        Gruppo g{{f1.c0 * f2.c0, f1.c0 * f2.c1 + f1.c1 * f2.c0, f1.c1 * f2.c1}, -f1.c1, f1.infinito && f2.infinito};
+        if (f1.infinito)
+        {
+            g.posizione = f2.infinito ? complex<double>(numeric_limits<double>::infinity(), 0) : -f2.c1;
+        }
+        return g;
+    }
+
+    Gruppo singolo(const Fattore &f)
+    {
+        Gruppo g{{f.c0, f.c1, 0}, -f.c1, f.infinito};
+        if (f.infinito)
+        {
+            g.posizione = complex<double>(numeric_limits<double>::infinity(), 0);
+        }
+        return g;
+    }
+
+    // Raggruppa le radici in gruppi del secondo ordine a coefficienti reali: le coppie complesse coniugate
+    // formano un gruppo, le radici reali sono accoppiate in ordine di distanza decrescente dall'origine
+    vector<Gruppo> raggruppa(vector<complex<double>> radici, size_t zeriInfiniti)
+    {
+        vector<Gruppo> gruppi;
+        vector<Fattore> reali;
+
+        while (!radici.empty())
+        {
+            complex<double> r = radici.back();
+            radici.pop_back();
+            if (fabs(r.imag()) <= TOLLERANZA_RADICE_REALE * max(1.0, abs(r)))
+            {
+                reali.push_back({1, -r.real(), fabs(r.real()), false});
+                continue;
+            }
+            // Cerca la coniugata più vicina
+            auto coniugata = min_element(radici.begin(), radici.end(), [&](const complex<double> &a, const complex<double> &b)
+                                         { return abs(a - conj(r)) < abs(b - conj(r)); });
+            if (coniugata == radici.end())
+            {
+                throw invalid_argument("convertiInSezioni: radice complessa senza coniugata");
+            }
+            radici.erase(coniugata);
+            complex<double> positiva = (r.imag() > 0) ? r : conj(r);
+            gruppi.push_back({{1, -2 * r.real(), norm(r)}, positiva, false});
+        }
+
+        for (size_t i = 0; i < zeriInfiniti; i++)
+        {
+            reali.push_back({0, 1, numeric_limits<double>::infinity(), true});
+        }
+        // Le radici finite più lontane dall'origine per prime, gli zeri all'infinito per ultimi
+        stable_sort(reali.begin(), reali.end(), [](const Fattore &a, const Fattore &b)
+                    { return !a.infinito && (b.infinito || a.raggio > b.raggio); });
+
+        for (size_t i = 0; i + 1 < reali.size(); i += 2)
+        {
+            gruppi.push_back(coppia(reali[i], reali[i + 1]));
+        }
+        if (reali.size() % 2 == 1)
+        {
+            gruppi.push_back(singolo(reali.back()));
+        }
+        return gruppi;
+    }
+
+    double distanzaDalCerchioUnitario(const Gruppo &g)
+    {
+        return fabs(1 - abs(g.posizione));
+    }
+}
+
+vector<SezioneBiquad<double>> convertiInSezioni(const vector<double> &output_coeff, const vector<double> &input_coeff)
+{
+    if (input_coeff.empty())
+    {
+        throw invalid_argument("convertiInSezioni: numeratore vuoto");
+    }
+
+    // Numeratore e denominatore in z^-1 della stessa lunghezza: B = b0 + b1 z^-1 + ..., A = 1 - a0 z^-1 - a1 z^-2 - ...
+    size_t lunghezza = max(input_coeff.size(), output_coeff.size() + 1);
+    vector<double> numeratore(lunghezza, 0), denominatore(lunghezza, 0);
+    copy(input_coeff.begin(), input_coeff.end(), numeratore.begin());
+    denominatore[0] = 1;
+    for (size_t i = 0; i < output_coeff.size(); i++)
+    {
+        denominatore[i + 1] = -output_coeff[i];
+    }
+
+    // I coefficienti nulli in testa al numeratore sono ritardi puri (zeri all'infinito)
+    size_t ritardi = 0;
+    while (ritardi < lunghezza && numeratore[ritardi] == 0)
+    {
+        ritardi++;
+    }
+    if (ritardi == lunghezza)
+    {
+        return {SezioneBiquad<double>{0, 0, 0, 0, 0}};
+    }
+    double guadagno = numeratore[ritardi];
+
+    vector<Gruppo> zeri = raggruppa(radiciPolinomio(vector<double>(numeratore.begin() + ritardi, numeratore.end())), ritardi);
+    vector<Gruppo> poli = raggruppa(radiciPolinomio(denominatore), 0);
+
+    // Accoppiamento: i poli più vicini alla circonferenza unitaria scelgono per primi gli zeri più vicini
+    sort(poli.begin(), poli.end(), [](const Gruppo &a, const Gruppo &b)
+         { return distanzaDalCerchioUnitario(a) < distanzaDalCerchioUnitario(b); });
+
+    vector<SezioneBiquad<double>> sezioni;
+    for (const Gruppo &polo : poli)
+    {
+        auto zero = min_element(zeri.begin(), zeri.end(), [&](const Gruppo &a, const Gruppo &b)
+                                {
+                                    if (a.infinito != b.infinito)
+                                        return b.infinito;
+                                    return abs(a.posizione - polo.posizione) < abs(b.posizione - polo.posizione); });
+        sezioni.push_back({zero->coefficienti[0], zero->coefficienti[1], zero->coefficienti[2],
+                           polo.coefficienti[1], polo.coefficienti[2]});
+        zeri.erase(zero);
+    }
+
+    // Regolatore di ordine zero: solo guadagno
+    if (sezioni.empty())
+    {
+        sezioni.push_back({1, 0, 0, 0, 0});
+    }
+
+    // I poli più vicini alla circonferenza unitaria sono valutati per ultimi
+    reverse(sezioni.begin(), sezioni.end());
+    sezioni[0].b0 *= guadagno;
+    sezioni[0].b1 *= guadagno;
+    sezioni[0].b2 *= guadagno;
+    return sezioni;
+}
@@ -0,0 +1,102 @@
+#ifndef SEZIONI_SECONDO_ORDINE_HPP
+#define SEZIONI_SECONDO_ORDINE_HPP
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Sezione del secondo ordine: H(z) = (b0 + b1 z^-1 + b2 z^-2) / (1 + a1 z^-1 + a2 z^-2)
+template <typename T>
+struct SezioneBiquad
+{
+    T b0, b1, b2;
+    T a1, a2;
+};
+
+// Scompone il regolatore definito dai coefficienti di Regolatore (output_coeff = coefficienti di y[k - 1] ... y[k - m],
+// input_coeff = coefficienti di u[k] ... u[k - n]) in una cascata di sezioni del secondo ordine.
+// Le radici di numeratore e denominatore sono calcolate in doppia precisione; ogni coppia di poli
+// (a partire dalla più vicina alla circonferenza unitaria) è accoppiata alla coppia di zeri più vicina e
+// le sezioni sono ordinate in modo che i poli più vicini alla circonferenza unitaria siano valutati per ultimi.
+// Il guadagno complessivo è applicato alla prima sezione.
+// Per regolatori di ordine elevato conviene passare i coefficienti in doppia precisione: l'arrotondamento a float
+// dei coefficienti della forma diretta può già spostare i poli fuori dalla circonferenza unitaria.
+std::vector<SezioneBiquad<double>> convertiInSezioni(const std::vector<double> &output_coeff, const std::vector<double> &input_coeff);
+
+inline std::vector<SezioneBiquad<double>> convertiInSezioni(const std::vector<float> &output_coeff, const std::vector<float> &input_coeff)
+{
+    return convertiInSezioni(std::vector<double>(output_coeff.begin(), output_coeff.end()),
+                             std::vector<double>(input_coeff.begin(), input_coeff.end()));
+}
+
+/*
+    Regolatore in forma di cascata di Sezioni sezioni del secondo ordine, ciascuna in forma diretta II trasposta:
+
+    y = b0 * x + s1
+    s1 = b1 * x - a1 * y + s2
+    s2 = b2 * x - a2 * y
+
+    Ogni sezione ha poli e zeri ben condizionati anche per regolatori di ordine elevato, a differenza della
+    forma diretta in float. Le sezioni non usate sono identità e non alterano il segnale.
+*/
+template <std::size_t Sezioni, typename T = float>
+class RegolatoreSos
+{
+private:
+    std::array<SezioneBiquad<T>, Sezioni> sezioni;
+    std::array<T, Sezioni> s1{};
+    std::array<T, Sezioni> s2{};
+
+    // Passo di una singola sezione: l'uscita diventa l'ingresso della sezione successiva
+    template <std::size_t I>
+    T passo(T x)
+    {
+        const SezioneBiquad<T> &sezione = sezioni[I];
+        T y = sezione.b0 * x + s1[I];
+        s1[I] = sezione.b1 * x - sezione.a1 * y + s2[I];
+        s2[I] = sezione.b2 * x - sezione.a2 * y;
+        return y;
+    }
+
+    template <std::size_t... I>
+    T cascata(T x, std::index_sequence<I...>)
+    {
+        ((x = passo<I>(x)), ...);
+        return x;
+    }
+
+public:
+    RegolatoreSos()
+    {
+        sezioni.fill(SezioneBiquad<T>{T(1), T(0), T(0), T(0), T(0)});
+    }
+
+    explicit RegolatoreSos(const std::vector<SezioneBiquad<double>> &sezioni_in) : RegolatoreSos()
+    {
+        if (sezioni_in.size() > Sezioni)
+        {
+            throw std::invalid_argument("RegolatoreSos: troppe sezioni");
+        }
+        for (std::size_t i = 0; i < sezioni_in.size(); i++)
+        {
+            const SezioneBiquad<double> &s = sezioni_in[i];
+            sezioni[i] = SezioneBiquad<T>{T(s.b0), T(s.b1), T(s.b2), T(s.a1), T(s.a2)};
+        }
+    }
+
+    T calculate_output(T input)
+    {
+        return cascata(input, std::make_index_sequence<Sezioni>{});
+    }
+
+    // Resetta tutte le variabili di stato a 0
+    void reset()
+    {
+        s1.fill(T(0));
+        s2.fill(T(0));
+    }
+};
+
+#endif
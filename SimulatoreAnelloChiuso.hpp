@@ -0,0 +1,226 @@
+#ifndef SIMULATORE_ANELLO_CHIUSO_HPP
+#define SIMULATORE_ANELLO_CHIUSO_HPP
+
+#include <ModelloMeca500.hpp>
+#include <ModelloSensoreIR.hpp>
+#include <OsservatoreDisturbo.hpp>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+// Configurazione della simulazione, con i valori di default di test_regolatore.cpp
+struct ConfigurazioneSimulazione
+{
+    double tempoCampionamento = 0.02;   // SAMPLING_TIME
+    double limiteInferiore = 30;         // Robot::POS_LIMIT_INF
+    double limiteSuperiore = 200;        // Robot::POS_LIMIT_SUP
+    double durataInterpolazione = 0.5;   // INTERPOLATION_DURATION, 0 per applicare subito il riferimento
+    ParametriMeca500 meca500;
+    ParametriSensoreIR sensore;
+};
+
+// Un campione della simulazione, con le stesse colonne del file csv del ciclo di controllo
+struct CampioneSimulazione
+{
+    double time;
+    double reference;
+    double position;
+    double measured_distance;
+    double error;
+    double velocity_control;
+};
+
+// Regolatori con anti-windup e inizializzazione bumpless (RegolatoreStatoSpazio)
+template <typename R, typename = void>
+struct HaAntiWindup : std::false_type
+{
+};
+
+template <typename R>
+struct HaAntiWindup<R, std::void_t<decltype(std::declval<R &>().applica(0.0f)), decltype(std::declval<R &>().inizializza(0.0f, 0.0f))>>
+    : std::true_type
+{
+};
+
+// Regolatori che usano anche la posizione misurata del robot (ControlloPredittivo)
+template <typename R, typename = void>
+struct UsaPosizione : std::false_type
+{
+};
+
+template <typename R>
+struct UsaPosizione<R, std::void_t<decltype(std::declval<R &>().calculate_output(0.0f, 0.0f))>> : std::true_type
+{
+};
+
+/*
+    Simulatore del ciclo di controllo di test_regolatore.cpp: a ogni passo misura la distanza dall'ostacolo
+    con il modello del sensore, interpola il riferimento, calcola la velocità con il regolatore, la annulla
+    ai limiti POS_LIMIT_INF/SUP e la applica al modello del Meca500 per un periodo di campionamento.
+    Con l'ostacolo fuori portata il robot viene fermato e il regolatore resettato, come in handleOutOfRange.
+    Se il regolatore ha applica() e inizializza() (HaAntiWindup) riceve la velocità effettivamente applicata
+    e al rientro dell'ostacolo viene inizializzato senza salti invece di essere resettato.
+
+    R è un qualunque regolatore con calculate_output(float) e reset() (Regolatore, RegolatoreFisso,
+    RegolatoreSos, RegolatoreVirgolaFissa, ...), oppure con calculate_output(errore, posizione) come
+    ControlloPredittivo (UsaPosizione): il passo non alloca e non usa chiamate virtuali.
+
+    Con setOsservatoreDisturbo() la compensazione dell'osservatore di disturbo viene sommata alla velocità
+    del regolatore prima dei limiti, come in test_regolatore.cpp con DISTURBANCE_OBSERVER.
+*/
+template <typename R>
+class SimulatoreAnelloChiuso
+{
+private:
+    R &regolatore;
+    OsservatoreDisturbo *osservatore = nullptr;
+    ConfigurazioneSimulazione configurazione;
+    ModelloMeca500 robot;
+    ModelloSensoreIR sensore;
+
+    double tempo = 0;
+    double riferimentoAttuale;
+    double riferimentoIniziale = 0;
+    double istanteInterpolazione = 0;
+    double ultimoRiferimento;
+    bool interpolazioneAttiva = true;
+    bool interpolazioneDaIniziare = true;
+    bool riacquisizione = false;
+    bool osservatoreDaInizializzare = true;
+
+public:
+    SimulatoreAnelloChiuso(R &regolatore, const ConfigurazioneSimulazione &configurazione, double posizioneIniziale, double riferimento)
+        : regolatore(regolatore), configurazione(configurazione),
+          robot(configurazione.meca500, configurazione.tempoCampionamento, posizioneIniziale),
+          sensore(configurazione.sensore), riferimentoAttuale(riferimento), ultimoRiferimento(riferimento)
+    {
+    }
+
+    // Un periodo del ciclo di controllo con l'ostacolo nella posizione x indicata (mm) e il riferimento
+    // finale richiesto (distanza negativa in mm, come finalReferenceDistance)
+    CampioneSimulazione passo(double posizioneOstacolo, double riferimento)
+    {
+        CampioneSimulazione campione;
+        campione.time = tempo;
+        campione.position = robot.getPosizione();
+
+        // Nuovo riferimento richiesto: interpolazione dalla distanza attuale
+        if (riferimento != ultimoRiferimento)
+        {
+            ultimoRiferimento = riferimento;
+            interpolazioneAttiva = true;
+            interpolazioneDaIniziare = true;
+        }
+
+        double distanzaMisurata = -sensore.misura(posizioneOstacolo - campione.position);
+        campione.measured_distance = distanzaMisurata;
+
+        double velocitaComandata = 0;
+        if (distanzaMisurata < -configurazione.sensore.portata)
+        {
+            // Ostacolo fuori portata: robot fermo e nuova interpolazione al rientro
+            if constexpr (HaAntiWindup<R>::value)
+            {
+                riacquisizione = true;
+            }
+            else
+            {
+                regolatore.reset();
+            }
+            interpolazioneAttiva = true;
+            interpolazioneDaIniziare = true;
+            osservatoreDaInizializzare = true;
+            campione.reference = riferimentoAttuale;
+            campione.error = 0;
+        }
+        else
+        {
+            // L'interpolazione parte dalla distanza misurata nel primo campione utile, come in regulator.cpp
+            if (interpolazioneDaIniziare)
+            {
+                riferimentoIniziale = distanzaMisurata;
+                istanteInterpolazione = tempo;
+                interpolazioneDaIniziare = false;
+            }
+            if (interpolazioneAttiva)
+            {
+                double pendenza = (configurazione.durataInterpolazione > 0) ? (riferimento - riferimentoIniziale) / configurazione.durataInterpolazione : 0;
+                riferimentoAttuale = pendenza * (tempo - istanteInterpolazione) + riferimentoIniziale;
+                if (configurazione.durataInterpolazione <= 0 ||
+                    (pendenza > 0 && riferimentoAttuale >= riferimento) || (pendenza <= 0 && riferimentoAttuale <= riferimento))
+                {
+                    riferimentoAttuale = riferimento;
+                    interpolazioneAttiva = false;
+                }
+            }
+
+            campione.reference = riferimentoAttuale;
+            campione.error = riferimentoAttuale - distanzaMisurata;
+            if constexpr (HaAntiWindup<R>::value)
+            {
+                // Ripartenza dal robot fermo
+                if (riacquisizione)
+                {
+                    regolatore.inizializza(campione.error, 0);
+                    riacquisizione = false;
+                }
+            }
+            if constexpr (UsaPosizione<R>::value)
+            {
+                velocitaComandata = regolatore.calculate_output(campione.error, campione.position);
+            }
+            else
+            {
+                velocitaComandata = regolatore.calculate_output(campione.error);
+            }
+            double compensazione = 0;
+            if (osservatore != nullptr)
+            {
+                if (osservatoreDaInizializzare)
+                {
+                    osservatore->reset(distanzaMisurata, campione.position);
+                    osservatoreDaInizializzare = false;
+                }
+                compensazione = osservatore->compensazione(distanzaMisurata, campione.position);
+                velocitaComandata += compensazione;
+            }
+
+            // Controllo delle posizioni limite ammesse
+            if (campione.position >= configurazione.limiteSuperiore && velocitaComandata > 0)
+            {
+                velocitaComandata = 0;
+            }
+            else if (campione.position <= configurazione.limiteInferiore && velocitaComandata < 0)
+            {
+                velocitaComandata = 0;
+            }
+            const double velocitaApplicata = std::clamp(velocitaComandata, -configurazione.meca500.velocitaMassima, configurazione.meca500.velocitaMassima);
+            if constexpr (HaAntiWindup<R>::value)
+            {
+                // Al regolatore la sola parte della velocità applicata che non viene dalla compensazione
+                regolatore.applica(velocitaApplicata - compensazione);
+            }
+            if (osservatore != nullptr)
+            {
+                osservatore->applica(velocitaApplicata);
+            }
+        }
+
+        campione.velocity_control = velocitaComandata;
+        robot.passo(velocitaComandata);
+        tempo += configurazione.tempoCampionamento;
+        return campione;
+    }
+
+    // Osservatore di disturbo usato dai passi successivi (nullptr per disattivarlo), inizializzato al primo campione utile
+    void setOsservatoreDisturbo(OsservatoreDisturbo *nuovoOsservatore)
+    {
+        osservatore = nuovoOsservatore;
+        osservatoreDaInizializzare = true;
+    }
+
+    const ModelloMeca500 &getRobot() const { return robot; }
+    double getTempo() const { return tempo; }
+};
+
+#endif
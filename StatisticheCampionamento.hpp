@@ -0,0 +1,54 @@
+#ifndef STATISTICHE_CAMPIONAMENTO_HPP
+#define STATISTICHE_CAMPIONAMENTO_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <ostream>
+
+// Statistiche in linea (metodo di Welford) del periodo di campionamento misurato, senza memorizzare i campioni
+class StatisticheCampionamento
+{
+private:
+    double periodoNominale;
+    double sogliaRitardo; // periodi oltre questa soglia sono contati come ritardi
+    std::size_t campioni = 0;
+    std::size_t ritardi = 0;
+    double media = 0;
+    double sommaScarti = 0;
+    double minimo = std::numeric_limits<double>::infinity();
+    double massimo = 0;
+
+public:
+    explicit StatisticheCampionamento(double periodoNominale, double fattoreRitardo = 1.5)
+        : periodoNominale(periodoNominale), sogliaRitardo(periodoNominale * fattoreRitardo) {}
+
+    void aggiungi(double periodo)
+    {
+        campioni++;
+        double scarto = periodo - media;
+        media += scarto / campioni;
+        sommaScarti += scarto * (periodo - media);
+        minimo = std::min(minimo, periodo);
+        massimo = std::max(massimo, periodo);
+        ritardi += periodo > sogliaRitardo;
+    }
+
+    std::size_t getCampioni() const { return campioni; }
+    std::size_t getRitardi() const { return ritardi; }
+    double getMedia() const { return media; }
+    double getMinimo() const { return minimo; }
+    double getMassimo() const { return massimo; }
+    double getDeviazioneStandard() const { return campioni > 1 ? std::sqrt(sommaScarti / (campioni - 1)) : 0; }
+
+    // Riepilogo in millisecondi
+    void stampa(std::ostream &out) const
+    {
+        out << "Periodo di campionamento (nominale " << periodoNominale * 1e3 << " ms) su " << campioni << " campioni: media "
+            << media * 1e3 << " ms, dev. std. " << getDeviazioneStandard() * 1e3 << " ms, min " << (campioni ? minimo : 0) * 1e3
+            << " ms, max " << massimo * 1e3 << " ms, oltre " << sogliaRitardo * 1e3 << " ms: " << ritardi << std::endl;
+    }
+};
+
+#endif
@@ -0,0 +1,102 @@
+#include <StimatoreOstacolo.hpp>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+StimatoreOstacolo::StimatoreOstacolo(const ParametriStimatoreOstacolo &parametri)
+    : parametri(parametri)
+{
+    if (!(parametri.rumoreMisura > 0) || !(parametri.rumoreAccelerazione > 0) || !(parametri.velocitaIniziale > 0) ||
+        !(parametri.sogliaInnovazione > 0) || parametri.scartiReinizializzazione == 0 || parametri.durataMassimaPredizione < 0)
+    {
+        throw invalid_argument("StimatoreOstacolo: parametri non validi");
+    }
+}
+
+void StimatoreOstacolo::inizializza(double posizioneMisurata)
+{
+    stato(0, 0) = posizioneMisurata;
+    stato(1, 0) = 0;
+    covarianza = MatriceFissa<2, 2>();
+    covarianza(0, 0) = parametri.rumoreMisura * parametri.rumoreMisura;
+    covarianza(1, 1) = parametri.velocitaIniziale * parametri.velocitaIniziale;
+    inizializzato = true;
+    scartiConsecutivi = 0;
+    tempoSenzaMisure = 0;
+}
+
+void StimatoreOstacolo::predici(double dt)
+{
+    MatriceFissa<2, 2> F = MatriceFissa<2, 2>::identita();
+    F(0, 1) = dt;
+    MatriceFissa<2, 2> Q;
+    const double q = parametri.rumoreAccelerazione;
+    Q(0, 0) = q * dt * dt * dt / 3;
+    Q(0, 1) = Q(1, 0) = q * dt * dt / 2;
+    Q(1, 1) = q * dt;
+
+    stato = F * stato;
+    covarianza = F * covarianza * F.trasposta() + Q;
+}
+
+bool StimatoreOstacolo::correggi(double posizioneMisurata)
+{
+    MatriceFissa<1, 2> H;
+    H(0, 0) = 1;
+    const double R = parametri.rumoreMisura * parametri.rumoreMisura;
+    const double innovazione = posizioneMisurata - stato(0, 0);
+    const double varianzaInnovazione = covarianza(0, 0) + R;
+
+    // Gating sulla distanza di Mahalanobis dell'innovazione
+    const double soglia = parametri.sogliaInnovazione;
+    if (innovazione * innovazione > soglia * soglia * varianzaInnovazione)
+    {
+        if (++scartiConsecutivi >= parametri.scartiReinizializzazione)
+        {
+            inizializza(posizioneMisurata);
+            return true;
+        }
+        return false;
+    }
+
+    // Guadagno e covarianza in forma di Joseph, simmetrica e definita positiva anche con arrotondamenti
+    const MatriceFissa<2, 1> K = covarianza * H.trasposta() * (1 / varianzaInnovazione);
+    const MatriceFissa<2, 2> IKH = MatriceFissa<2, 2>::identita() - K * H;
+    stato = stato + K * innovazione;
+    covarianza = IKH * covarianza * IKH.trasposta() + K * K.trasposta() * R;
+    scartiConsecutivi = 0;
+    tempoSenzaMisure = 0;
+    return true;
+}
+
+bool StimatoreOstacolo::passo(float distanzaMisurata, float posizioneRobot, bool misuraDisponibile, double dt)
+{
+    // Posizione dell'ostacolo nel mondo: currentDistance = posizione del robot - posizione dell'ostacolo
+    const double posizioneMisurata = (double)posizioneRobot - distanzaMisurata;
+    if (!inizializzato)
+    {
+        if (misuraDisponibile)
+        {
+            inizializza(posizioneMisurata);
+        }
+        return misuraDisponibile;
+    }
+
+    predici(dt);
+    tempoSenzaMisure += dt;
+    return misuraDisponibile && correggi(posizioneMisurata);
+}
+
+double StimatoreOstacolo::getDeviazionePosizione() const
+{
+    return sqrt(covarianza(0, 0));
+}
+
+void StimatoreOstacolo::reset()
+{
+    inizializzato = false;
+    stato = MatriceFissa<2, 1>();
+    scartiConsecutivi = 0;
+    tempoSenzaMisure = 0;
+}
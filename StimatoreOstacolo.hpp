@@ -0,0 +1,71 @@
+#ifndef STIMATORE_OSTACOLO_HPP
+#define STIMATORE_OSTACOLO_HPP
+
+#include <cstddef>
+#include <MatriceFissa.hpp>
+
+// Parametri del filtro di Kalman sull'ostacolo
+struct ParametriStimatoreOstacolo
+{
+    double rumoreMisura = 2.0;                 // mm, misura del sensore con quantizzazione e sfasamento rispetto alla posizione del robot
+    double rumoreAccelerazione = 6e4;          // mm^2/s^3, densità spettrale dell'accelerazione dell'ostacolo
+    double velocitaIniziale = 100;             // mm/s, deviazione standard della velocità all'inizializzazione
+    double sogliaInnovazione = 4;              // deviazioni standard oltre le quali una misura è scartata
+    std::size_t scartiReinizializzazione = 5;  // misure consecutive scartate dopo le quali l'ostacolo è davvero saltato
+    double durataMassimaPredizione = 0.3;      // s senza misure accettate oltre i quali la stima non è più valida
+};
+
+/*
+    Filtro di Kalman della posizione x dell'ostacolo nel riferimento del mondo, con il modello a velocità
+    costante (accelerazione come rumore bianco):
+
+        stato = [posizione, velocita],  F = [1 dt; 0 1],  Q = q [dt^3/3 dt^2/2; dt^2/2 dt]
+
+    La misura è posizione del robot (Robot::get_position, x di Meca500::getPose) meno la distanza misurata
+    (currentDistance, negativa): il moto del robot non entra nel modello dell'ostacolo, che resta quasi fermo
+    o lento anche quando il robot si muove, e la distanza filtrata è posizione del robot meno quella stimata.
+
+    Le misure con innovazione oltre sogliaInnovazione deviazioni standard sono scartate (riflessi e letture
+    spurie del sensore); dopo scartiReinizializzazione scarti consecutivi l'ostacolo è considerato spostato
+    e il filtro riparte dalla misura. Senza misure (fuori portata o scartate) il filtro prosegue con la sola
+    predizione per al massimo durataMassimaPredizione: il ciclo di controllo può attraversare brevi perdite
+    del sensore invece di fermare il robot. Il periodo di ogni passo è quello misurato.
+
+    Tutte le matrici sono MatriceFissa 2x2, 2x1 e 1x2: un passo non alloca.
+*/
+class StimatoreOstacolo
+{
+private:
+    ParametriStimatoreOstacolo parametri;
+    MatriceFissa<2, 1> stato;
+    MatriceFissa<2, 2> covarianza;
+    bool inizializzato = false;
+    std::size_t scartiConsecutivi = 0;
+    double tempoSenzaMisure = 0;
+
+    void inizializza(double posizioneMisurata);
+    void predici(double dt);
+    bool correggi(double posizioneMisurata);
+
+public:
+    explicit StimatoreOstacolo(const ParametriStimatoreOstacolo &parametri = ParametriStimatoreOstacolo());
+
+    // Un periodo di durata dt (s) con la distanza misurata (negativa, mm) e la posizione del robot (mm).
+    // Con misuraDisponibile false (ostacolo fuori portata) solo predizione. Ritorna true se la misura è stata usata.
+    bool passo(float distanzaMisurata, float posizioneRobot, bool misuraDisponibile, double dt);
+
+    // Stima utilizzabile: inizializzata e con una misura accettata da meno di durataMassimaPredizione
+    bool isValida() const { return inizializzato && tempoSenzaMisure <= parametri.durataMassimaPredizione; }
+
+    // Distanza filtrata dall'ostacolo vista dal robot nella posizione indicata (negativa, come currentDistance)
+    float getDistanza(float posizioneRobot) const { return (float)(posizioneRobot - stato(0, 0)); }
+
+    double getPosizione() const { return stato(0, 0); }
+    double getVelocita() const { return stato(1, 0); }
+    double getDeviazionePosizione() const;
+
+    // La prossima misura disponibile reinizializza il filtro
+    void reset();
+};
+
+#endif
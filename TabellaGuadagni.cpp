@@ -0,0 +1,139 @@
+#include <TabellaGuadagni.hpp>
+#include <Polinomi.hpp>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+// Punti intermedi verificati tra due progetti adiacenti della tabella
+#define VERIFICHE_PER_INTERVALLO 8
+
+namespace
+{
+    // Interpolazione lineare dei coefficienti (quelli oltre l'ordine di un progetto sono nulli)
+    void interpolaCoefficienti(const CoefficientiFissi &a, const CoefficientiFissi &b, double peso, CoefficientiFissi &risultato)
+    {
+        for (size_t i = 0; i < risultato.input_coeff.size(); i++)
+        {
+            risultato.input_coeff[i] = a.input_coeff[i] + peso * (b.input_coeff[i] - a.input_coeff[i]);
+        }
+        for (size_t i = 0; i < risultato.output_coeff.size(); i++)
+        {
+            risultato.output_coeff[i] = a.output_coeff[i] + peso * (b.output_coeff[i] - a.output_coeff[i]);
+        }
+        risultato.numeroIngresso = max(a.numeroIngresso, b.numeroIngresso);
+        risultato.numeroUscita = max(a.numeroUscita, b.numeroUscita);
+    }
+
+    bool coefficientiStabili(const CoefficientiFissi &c)
+    {
+        vector<double> denominatore{1};
+        for (size_t i = 0; i < c.numeroUscita; i++)
+        {
+            denominatore.push_back(-c.output_coeff[i]);
+        }
+        for (const complex<double> &polo : radiciPolinomio(denominatore))
+        {
+            if (abs(polo) >= 1)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+TabellaGuadagni::TabellaGuadagni(double distanzaMinima, double passo, const vector<FunzioneTrasferimentoContinua> &progetti,
+                                 double tempoCampionamento)
+    : distanzaMinima(distanzaMinima), passo(passo)
+{
+    if (progetti.empty() || !(passo > 0))
+    {
+        throw invalid_argument("TabellaGuadagni: servono almeno un progetto e un passo positivo");
+    }
+    for (const FunzioneTrasferimentoContinua &progetto : progetti)
+    {
+        CoefficientiRegolatore discreto = discretizza(progetto, tempoCampionamento, DISCRETIZZAZIONE_POLI_ZERI);
+        coefficienti.emplace_back(discreto.output_coeff, discreto.input_coeff);
+        // Inversa di Tustin dei coefficienti: al periodo nominale le due forme danno la stessa uscita
+        sezioni.emplace_back(continuaDaTustin(discreto.output_coeff, discreto.input_coeff, tempoCampionamento));
+    }
+
+    for (size_t i = 1; i < sezioni.size(); i++)
+    {
+        bool stessaStruttura = sezioni[i].numeroSezioni == sezioni[0].numeroSezioni;
+        for (size_t s = 0; stessaStruttura && s < sezioni[0].numeroSezioni; s++)
+        {
+            stessaStruttura = sezioni[i].sezioni[s].ordine == sezioni[0].sezioni[s].ordine;
+        }
+        if (!stessaStruttura)
+        {
+            throw invalid_argument("TabellaGuadagni: il progetto " + to_string(i) + " ha sezioni diverse dal primo");
+        }
+    }
+
+    CoefficientiFissi intermedio;
+    for (size_t i = 0; i < coefficienti.size(); i++)
+    {
+        const size_t successivo = min(i + 1, coefficienti.size() - 1);
+        const int verifiche = (successivo == i) ? 1 : VERIFICHE_PER_INTERVALLO;
+        for (int k = 0; k < verifiche; k++)
+        {
+            interpolaCoefficienti(coefficienti[i], coefficienti[successivo], (double)k / VERIFICHE_PER_INTERVALLO, intermedio);
+            if (!coefficientiStabili(intermedio))
+            {
+                throw invalid_argument("TabellaGuadagni: regolatore instabile a " +
+                                       to_string(distanzaMinima + (i + (double)k / VERIFICHE_PER_INTERVALLO) * passo) + " mm");
+            }
+        }
+    }
+}
+
+size_t TabellaGuadagni::punto(double distanza, double &peso) const
+{
+    double posizione = (distanza - distanzaMinima) / passo;
+    if (!(posizione > 0))
+    {
+        peso = 0;
+        return 0;
+    }
+    const size_t ultimo = coefficienti.size() - 1;
+    if (posizione >= ultimo)
+    {
+        peso = 0;
+        return ultimo;
+    }
+    size_t i = (size_t)posizione;
+    peso = posizione - i;
+    return i;
+}
+
+void TabellaGuadagni::interpola(double distanza, CoefficientiFissi &risultato) const
+{
+    double peso;
+    size_t i = punto(distanza, peso);
+    interpolaCoefficienti(coefficienti[i], coefficienti[min(i + 1, coefficienti.size() - 1)], peso, risultato);
+}
+
+void TabellaGuadagni::interpola(double distanza, SezioniContinue &risultato) const
+{
+    double peso;
+    size_t i = punto(distanza, peso);
+    const SezioniContinue &a = sezioni[i];
+    const SezioniContinue &b = sezioni[min(i + 1, sezioni.size() - 1)];
+    risultato.numeroSezioni = a.numeroSezioni;
+    risultato.guadagno = a.guadagno + peso * (b.guadagno - a.guadagno);
+    for (size_t s = 0; s < a.numeroSezioni; s++)
+    {
+        const SezioneContinua &sa = a.sezioni[s], &sb = b.sezioni[s];
+        SezioneContinua &r = risultato.sezioni[s];
+        r.ordine = sa.ordine;
+        r.n0 = sa.n0 + peso * (sb.n0 - sa.n0);
+        r.n1 = sa.n1 + peso * (sb.n1 - sa.n1);
+        r.n2 = sa.n2 + peso * (sb.n2 - sa.n2);
+        r.d0 = sa.d0 + peso * (sb.d0 - sa.d0);
+        r.d1 = sa.d1 + peso * (sb.d1 - sa.d1);
+    }
+}
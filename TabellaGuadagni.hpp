@@ -0,0 +1,51 @@
+#ifndef TABELLA_GUADAGNI_HPP
+#define TABELLA_GUADAGNI_HPP
+
+#include <cstddef>
+#include <vector>
+#include <Discretizzazione.hpp>
+#include <RegolatoreStatoSpazio.hpp>
+#include <RegolatoreTempoVariabile.hpp>
+
+/*
+    Tabella per il gain scheduling: un progetto del regolatore per ogni distanza di lavoro, su una griglia
+    uniforme (distanzaMinima, distanzaMinima + passo, ...), così che il punto della tabella si trovi con una
+    divisione invece che con una ricerca.
+
+    I progetti sono convertiti una volta sola, alla costruzione, nelle due forme usate dal ciclo di controllo:
+    coefficienti per RegolatoreStatoSpazio e sezioni tempo continuo per RegolatoreTempoVariabile, ottenute dai
+    coefficienti con continuaDaTustin perché al periodo nominale le due forme coincidano. A ogni campione
+    interpola() scrive in una struttura a dimensione fissa del chiamante l'interpolazione lineare tra i due punti
+    adiacenti, senza allocare; oltre gli estremi della griglia si usa il progetto dell'estremo.
+
+    Per le sezioni tempo continuo la stabilità è conservata: ogni sezione interpolata ha d0, d1 combinazione
+    convessa di valori positivi. Per i coefficienti tempo discreto questo vale solo fino al secondo ordine, e
+    il costruttore verifica i poli anche tra un punto e l'altro.
+*/
+class TabellaGuadagni
+{
+private:
+    double distanzaMinima;
+    double passo;
+    std::vector<CoefficientiFissi> coefficienti;
+    std::vector<SezioniContinue> sezioni;
+
+    // Punto della griglia a sinistra della distanza e peso del punto successivo
+    std::size_t punto(double distanza, double &peso) const;
+
+public:
+    // progetti[i] è il regolatore per la distanza distanzaMinima + i * passo (mm), discretizzato con
+    // DISCRETIZZAZIONE_POLI_ZERI e il periodo indicato per la forma a coefficienti. Le sezioni di tutti i
+    // progetti devono avere la stessa struttura (stesso numero di poli reali e complessi).
+    TabellaGuadagni(double distanzaMinima, double passo, const std::vector<FunzioneTrasferimentoContinua> &progetti,
+                    double tempoCampionamento);
+
+    void interpola(double distanza, CoefficientiFissi &risultato) const;
+    void interpola(double distanza, SezioniContinue &risultato) const;
+
+    std::size_t getNumeroPunti() const { return coefficienti.size(); }
+    double getDistanzaMinima() const { return distanzaMinima; }
+    double getPasso() const { return passo; }
+};
+
+#endif
@@ -0,0 +1,143 @@
+#include <TracciaLatenza.hpp>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <time.h>
+
+using namespace std;
+
+namespace
+{
+    // Tratto della catena tra due istanti dello stesso record
+    struct Tratto
+    {
+        const char *nome;
+        int64_t (*inizio)(const RecordLatenza &);
+        int64_t (*fine)(const RecordLatenza &);
+    };
+
+    const Tratto TRATTI[] = {
+        {"seriale del sensore", [](const RecordLatenza &r) { return r.richiestaSensore; }, [](const RecordLatenza &r) { return r.rispostaSensore; }},
+        {"risposta - calcolo", [](const RecordLatenza &r) { return r.rispostaSensore; }, [](const RecordLatenza &r) { return r.calcolo; }},
+        {"calcolo - scrittura PDO", [](const RecordLatenza &r) { return r.calcolo; }, [](const RecordLatenza &r) { return r.scritturaPdo; }},
+        {"scrittura PDO - invio EtherCAT", [](const RecordLatenza &r) { return r.scritturaPdo; }, [](const RecordLatenza &r) { return r.invioEthercat.load(); }},
+        {"invio - prima retroazione", [](const RecordLatenza &r) { return r.invioEthercat.load(); }, [](const RecordLatenza &r) { return r.primaRetroazione.load(); }},
+        {"richiesta sensore - invio", [](const RecordLatenza &r) { return r.richiestaSensore; }, [](const RecordLatenza &r) { return r.invioEthercat.load(); }},
+        {"richiesta sensore - retroazione", [](const RecordLatenza &r) { return r.richiestaSensore; }, [](const RecordLatenza &r) { return r.primaRetroazione.load(); }},
+    };
+
+    double percentile(const vector<int64_t> &ordinati, double p)
+    {
+        size_t indice = (size_t)ceil(p * ordinati.size()) - 1;
+        return ordinati[min(indice, ordinati.size() - 1)] * 1e-6;
+    }
+}
+
+TracciaLatenza::TracciaLatenza(size_t capacita, size_t cicliFermo, float sogliaMovimento, double attesaMassima)
+    : records(capacita), cicliFermo(cicliFermo), sogliaMovimento(sogliaMovimento), attesaMassima(llround(attesaMassima * 1e9))
+{
+    if (capacita == 0 || sogliaMovimento < 0 || !(attesaMassima > 0))
+    {
+        throw invalid_argument("TracciaLatenza: parametri non validi");
+    }
+}
+
+int64_t TracciaLatenza::adesso()
+{
+    timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (int64_t)t.tv_sec * 1000000000LL + t.tv_nsec;
+}
+
+void TracciaLatenza::registra(int64_t richiestaSensore, int64_t rispostaSensore, int64_t calcolo, float velocita)
+{
+    uint64_t numero = pubblicati.load(memory_order_relaxed) + 1;
+    RecordLatenza &r = record(numero);
+    r.richiestaSensore = richiestaSensore;
+    r.rispostaSensore = rispostaSensore;
+    r.calcolo = calcolo;
+    r.scritturaPdo = adesso();
+    r.velocita = velocita;
+    r.invioEthercat.store(0, memory_order_relaxed);
+    r.primaRetroazione.store(0, memory_order_relaxed);
+    pubblicati.store(numero, memory_order_release);
+}
+
+void TracciaLatenza::cicloEthercat(void *traccia, int64_t invio, float x)
+{
+    TracciaLatenza &t = *static_cast<TracciaLatenza *>(traccia);
+
+    // Ultimo record scritto dal ciclo di controllo: i precedenti senza invio restano incompleti
+    uint64_t ultimo = t.pubblicati.load(memory_order_acquire);
+    if (ultimo != t.ultimoVisto)
+    {
+        t.inAttesaInvio = t.ultimoVisto = ultimo;
+    }
+
+    // Il movimento atteso è quello del ciclo precedente: x qui è la posizione ricevuta in questo ciclo
+    if (t.inAttesaRetroazione != 0)
+    {
+        RecordLatenza &r = t.record(t.inAttesaRetroazione);
+        if (fabs(x - t.xRiferimento) > t.sogliaMovimento)
+        {
+            r.primaRetroazione.store(invio, memory_order_relaxed);
+            t.inAttesaRetroazione = 0;
+        }
+        else if (invio - r.invioEthercat.load(memory_order_relaxed) > t.attesaMassima)
+        {
+            // Comando senza effetto visibile (limite di posizione, robot in errore): record incompleto
+            t.inAttesaRetroazione = 0;
+        }
+    }
+
+    // Un invio iniziato prima della scrittura non contiene il comando
+    if (t.inAttesaInvio != 0)
+    {
+        RecordLatenza &r = t.record(t.inAttesaInvio);
+        if (invio > r.scritturaPdo)
+        {
+            r.invioEthercat.store(invio, memory_order_relaxed);
+            if (t.inAttesaRetroazione == 0 && t.cicliUguali >= t.cicliFermo && r.velocita != 0)
+            {
+                t.inAttesaRetroazione = t.inAttesaInvio;
+                t.xRiferimento = x;
+            }
+            t.inAttesaInvio = 0;
+        }
+    }
+
+    t.cicliUguali = (x == t.xPrecedente) ? t.cicliUguali + 1 : 0;
+    t.xPrecedente = x;
+}
+
+void TracciaLatenza::stampa(ostream &out) const
+{
+    uint64_t numero = pubblicati.load(memory_order_acquire);
+    size_t disponibili = (size_t)min<uint64_t>(numero, records.size());
+    out << "Latenza sensore - attuazione su " << disponibili << " campioni (ms: mediana, 90%, 99%, max)" << endl;
+
+    vector<int64_t> durate;
+    durate.reserve(disponibili);
+    for (const Tratto &tratto : TRATTI)
+    {
+        durate.clear();
+        for (size_t i = 0; i < disponibili; i++)
+        {
+            const RecordLatenza &r = records[i];
+            int64_t inizio = tratto.inizio(r), fine = tratto.fine(r);
+            if (inizio != 0 && fine != 0)
+            {
+                durate.push_back(fine - inizio);
+            }
+        }
+        out << "  " << tratto.nome << ": ";
+        if (durate.empty())
+        {
+            out << "nessun campione" << endl;
+            continue;
+        }
+        sort(durate.begin(), durate.end());
+        out << percentile(durate, 0.5) << ", " << percentile(durate, 0.9) << ", " << percentile(durate, 0.99) << ", "
+            << durate.back() * 1e-6 << " (" << durate.size() << " campioni)" << endl;
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef TRACCIA_LATENZA_HPP
+#define TRACCIA_LATENZA_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// Istanti di un campione lungo la catena sensore - attuazione (ns, CLOCK_MONOTONIC; 0 se non misurato)
+struct alignas(64) RecordLatenza
+{
+    int64_t richiestaSensore = 0;              // richiesta della misura sulla seriale
+    int64_t rispostaSensore = 0;               // risposta del sensore
+    int64_t calcolo = 0;                       // fine del calcolo della velocità
+    int64_t scritturaPdo = 0;                  // fine di moveLinVelWRF (comando nel process image)
+    float velocita = 0;                        // mm/s, velocità comandata
+    std::atomic<int64_t> invioEthercat{0};     // primo ec_send_processdata dopo la scrittura
+    std::atomic<int64_t> primaRetroazione{0};  // primo ciclo con cartesian_position.x cambiata (solo dal robot fermo)
+};
+
+/*
+    Tracciamento della latenza tra la misura del sensore e la risposta del Meca500.
+
+    Il ciclo di controllo chiama registra() dopo move_lin_vel_wrf con gli istanti del sensore e del calcolo; il
+    thread EtherCAT chiama cicloEthercat() a ogni ciclo (Robot::set_cycle_callback) e completa l'ultimo record
+    con l'istante del primo invio del process image successivo alla scrittura. Se a quell'invio il robot era
+    fermo da almeno cicliFermo cicli e la velocità comandata non è nulla, il record è seguito finché la posizione
+    x ricevuta non cambia di più di sogliaMovimento (al più per attesaMassima): con il robot in moto x cambia a
+    ogni ciclo e la reazione al comando non è distinguibile.
+
+    I record sono in un anello preallocato (i più vecchi sono sovrascritti): registra() e cicloEthercat() non
+    allocano né prendono lock, il record passa al thread EtherCAT con un indice atomico. stampa() riporta per
+    ogni tratto della catena mediana, 90°, 99° percentile e massimo, da chiamare a ciclo fermo.
+*/
+class TracciaLatenza
+{
+private:
+    std::vector<RecordLatenza> records;
+    std::size_t cicliFermo;
+    float sogliaMovimento;
+    int64_t attesaMassima; // ns
+    alignas(64) std::atomic<uint64_t> pubblicati{0}; // record scritti dal ciclo di controllo
+
+    // Stato del thread EtherCAT
+    alignas(64) uint64_t ultimoVisto = 0;    // ultimo record pubblicato già considerato
+    uint64_t inAttesaInvio = 0;              // numero (da 1) dell'ultimo record senza invio, 0 se nessuno
+    uint64_t inAttesaRetroazione = 0;        // record di cui si aspetta il movimento, 0 se nessuno
+    float xPrecedente = 0, xRiferimento = 0;
+    std::size_t cicliUguali = 0;
+
+    RecordLatenza &record(uint64_t numero) { return records[(numero - 1) % records.size()]; }
+
+public:
+    explicit TracciaLatenza(std::size_t capacita = 1 << 14, std::size_t cicliFermo = 3, float sogliaMovimento = 0, double attesaMassima = 0.5);
+
+    static int64_t adesso(); // ns, CLOCK_MONOTONIC
+
+    // Ciclo di controllo, subito dopo la scrittura del comando
+    void registra(int64_t richiestaSensore, int64_t rispostaSensore, int64_t calcolo, float velocita);
+
+    // Thread EtherCAT, da passare a Robot::set_cycle_callback con this come contesto
+    static void cicloEthercat(void *traccia, int64_t invio, float x);
+
+    // Scomposizione della latenza in millisecondi
+    void stampa(std::ostream &out) const;
+};
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef TRIPLO_BUFFER_HPP
+#define TRIPLO_BUFFER_HPP
+
+#include <atomic>
+#include <cstdint>
+
+/*
+    Scambio lock-free dell'ultimo valore tra un solo thread scrittore e un solo thread lettore.
+
+    I tre buffer sono: quello su cui scrive lo scrittore, quello in uso dal lettore e uno intermedio.
+    pubblica() scambia il buffer scritto con quello intermedio, aggiorna() scambia quello intermedio con quello
+    letto se contiene un valore nuovo. Gli scambi sono un'unica exchange atomica, quindi nessuno dei due thread
+    attende l'altro né alloca memoria, e il lettore non vede mai un valore scritto a metà.
+    Se lo scrittore pubblica più volte prima che il lettore aggiorni, il lettore riceve solo l'ultimo valore.
+*/
+template <typename T>
+class TriploBuffer
+{
+private:
+    static constexpr uint8_t NUOVO = 0x4;   // il buffer intermedio contiene un valore non ancora letto
+    static constexpr uint8_t INDICE = 0x3;
+
+    struct alignas(64) Cella
+    {
+        T valore;
+    };
+
+    Cella celle[3];
+    alignas(64) std::atomic<uint8_t> intermedio{1};
+    alignas(64) uint8_t indiceScrittura = 0; // usato solo dallo scrittore
+    alignas(64) uint8_t indiceLettura = 2;   // usato solo dal lettore
+
+public:
+    TriploBuffer() = default;
+    explicit TriploBuffer(const T &iniziale)
+    {
+        for (Cella &cella : celle)
+        {
+            cella.valore = iniziale;
+        }
+    }
+
+    // Scrittore: buffer da riempire prima di pubblica()
+    T &scrittura() { return celle[indiceScrittura].valore; }
+
+    // Scrittore: rende disponibile al lettore il valore scritto
+    void pubblica()
+    {
+        indiceScrittura = intermedio.exchange(indiceScrittura | NUOVO, std::memory_order_acq_rel) & INDICE;
+    }
+
+    void pubblica(const T &valore)
+    {
+        scrittura() = valore;
+        pubblica();
+    }
+
+    // Lettore: prende l'ultimo valore pubblicato, ritorna false se non ce ne sono di nuovi
+    bool aggiorna()
+    {
+        if (!(intermedio.load(std::memory_order_relaxed) & NUOVO))
+        {
+            return false;
+        }
+        indiceLettura = intermedio.exchange(indiceLettura, std::memory_order_acq_rel) & INDICE;
+        return true;
+    }
+
+    // Lettore: ultimo valore preso con aggiorna()
+    const T &lettura() const { return celle[indiceLettura].valore; }
+};
+
+#endif
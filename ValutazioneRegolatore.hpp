@@ -0,0 +1,115 @@
+#ifndef VALUTAZIONE_REGOLATORE_HPP
+#define VALUTAZIONE_REGOLATORE_HPP
+
+#include <SimulatoreAnelloChiuso.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/*
+    Scenario di prova per confrontare regolatori sul simulatore:
+    - il robot parte fermo con l'ostacolo a distanzaIniziale e deve portarsi al riferimento (gradino interpolato)
+    - all'istante inizioRampa l'ostacolo si allontana a velocitaOstacolo per durataRampa (disturbo a rampa)
+*/
+struct ScenarioProva
+{
+    double posizioneIniziale = 80;   // mm, entro POS_LIMIT_INF/SUP
+    double distanzaIniziale = 100;   // mm
+    double riferimento = -50;        // mm, come DEFAULT_REFERENCE_mm
+    double inizioRampa = 3.0;        // s
+    double velocitaOstacolo = 60;    // mm/s
+    double durataRampa = 0.5;        // s
+    double durata = 6.0;             // s
+    double finestraRegime = 1.0;     // s finali usati per verificare la convergenza
+    double erroreRegimeMassimo = 5;  // mm, errore medio ammesso a regime
+    double bandaAssestamento = 2;    // mm, banda attorno al riferimento per il tempo di assestamento
+};
+
+struct IndiciPrestazione
+{
+    double iae = 0;              // integrale dell'errore assoluto, mm*s
+    double sovraelongazione = 0; // mm oltre il riferimento durante il gradino
+    double saturazione = 0;      // frazione dei campioni con velocità comandata alla velocità massima
+    double velocitaMassima = 0;  // mm/s, valore assoluto massimo della velocità comandata
+    double tempoAssestamento = 0; // s dall'inizio del gradino all'ultimo ingresso nella banda (infinito se non entra prima della rampa)
+    bool stabile = true;         // errore a regime entro erroreRegimeMassimo e robot entro i limiti
+
+    // Costo scalare: IAE più sovraelongazione e saturazione pesate, infinito se il ciclo non converge
+    double costo(double pesoSovraelongazione, double pesoSaturazione) const
+    {
+        if (!stabile)
+        {
+            return std::numeric_limits<double>::infinity();
+        }
+        return iae + pesoSovraelongazione * sovraelongazione + pesoSaturazione * saturazione;
+    }
+};
+
+// Simula lo scenario con il regolatore indicato (che viene resettato) e ne calcola gli indici di prestazione
+template <typename R>
+IndiciPrestazione valutaRegolatore(R &regolatore, const ConfigurazioneSimulazione &configurazione, const ScenarioProva &scenario = ScenarioProva())
+{
+    regolatore.reset();
+    SimulatoreAnelloChiuso<R> simulatore(regolatore, configurazione, scenario.posizioneIniziale, scenario.riferimento);
+
+    IndiciPrestazione indici;
+    const double Tc = configurazione.tempoCampionamento;
+    const size_t passi = (size_t)std::lround(scenario.durata / Tc);
+    const size_t passiRegime = std::max<size_t>(1, (size_t)std::lround(scenario.finestraRegime / Tc));
+    const double distanzaFinale = -scenario.riferimento;
+    double posizioneOstacolo = scenario.posizioneIniziale + scenario.distanzaIniziale;
+    double erroreRegime = 0;
+    size_t campioniSaturi = 0;
+    bool fuoriBanda = true;
+
+    for (size_t k = 0; k < passi; k++)
+    {
+        double t = k * Tc;
+        if (t >= scenario.inizioRampa && t < scenario.inizioRampa + scenario.durataRampa)
+        {
+            posizioneOstacolo += scenario.velocitaOstacolo * Tc;
+        }
+
+        CampioneSimulazione campione = simulatore.passo(posizioneOstacolo, scenario.riferimento);
+        double distanzaVera = posizioneOstacolo - campione.position;
+        double errore = distanzaVera - distanzaFinale;
+
+        indici.iae += std::fabs(campione.error) * Tc;
+        if (t < scenario.inizioRampa)
+        {
+            // Gradino: sovraelongazione oltre il riferimento nel verso del movimento
+            double oltre = (scenario.distanzaIniziale > distanzaFinale) ? -errore : errore;
+            indici.sovraelongazione = std::max(indici.sovraelongazione, oltre);
+            fuoriBanda = std::fabs(errore) > scenario.bandaAssestamento;
+            if (fuoriBanda)
+            {
+                indici.tempoAssestamento = t + Tc;
+            }
+        }
+        double velocita = std::fabs(campione.velocity_control);
+        indici.velocitaMassima = std::max(indici.velocitaMassima, velocita);
+        if (velocita >= configurazione.meca500.velocitaMassima)
+        {
+            campioniSaturi++;
+        }
+        if (k + passiRegime >= passi)
+        {
+            erroreRegime += std::fabs(errore);
+        }
+        if (!std::isfinite(campione.position) || campione.position < configurazione.limiteInferiore ||
+            campione.position > configurazione.limiteSuperiore)
+        {
+            indici.stabile = false;
+        }
+    }
+
+    indici.saturazione = (double)campioniSaturi / passi;
+    if (fuoriBanda)
+    {
+        indici.tempoAssestamento = std::numeric_limits<double>::infinity();
+    }
+    indici.stabile = indici.stabile && erroreRegime / passiRegime <= scenario.erroreRegimeMassimo;
+    return indici;
+}
+
+#endif
@@ -0,0 +1,122 @@
+#ifndef VETTORE_SIMD_HPP
+#define VETTORE_SIMD_HPP
+
+#include <cstddef>
+
+// Astrazione minima di un registro SIMD di float, scelta a tempo di compilazione
+// in base al set di istruzioni disponibile (AVX, SSE, NEON) con ripiego scalare.
+// carica/salva richiedono indirizzi allineati; componi costruisce il registro nei registri
+// a partire da n <= LARGHEZZA float non allineati (gli elementi mancanti valgono 0), evitando
+// lo stallo dovuto alla rilettura vettoriale di valori appena scritti come scalari.
+#if defined(__AVX__)
+#include <immintrin.h>
+#define SIMD_NOME "AVX"
+struct VettoreSimd
+{
+    static constexpr std::size_t LARGHEZZA = 8;
+    __m256 v;
+
+    static VettoreSimd zero() { return {_mm256_setzero_ps()}; }
+    static VettoreSimd costante(float x) { return {_mm256_set1_ps(x)}; }
+    static VettoreSimd carica(const float *p) { return {_mm256_load_ps(p)}; }
+    static VettoreSimd componi(const float *p, std::size_t n)
+    {
+        return {_mm256_setr_ps(p[0], n > 1 ? p[1] : 0.0f, n > 2 ? p[2] : 0.0f, n > 3 ? p[3] : 0.0f,
+                               n > 4 ? p[4] : 0.0f, n > 5 ? p[5] : 0.0f, n > 6 ? p[6] : 0.0f, n > 7 ? p[7] : 0.0f)};
+    }
+    void salva(float *p) const { _mm256_store_ps(p, v); }
+    friend VettoreSimd operator+(VettoreSimd a, VettoreSimd b) { return {_mm256_add_ps(a.v, b.v)}; }
+    friend VettoreSimd operator-(VettoreSimd a, VettoreSimd b) { return {_mm256_sub_ps(a.v, b.v)}; }
+    friend VettoreSimd operator*(VettoreSimd a, VettoreSimd b) { return {_mm256_mul_ps(a.v, b.v)}; }
+    friend VettoreSimd operator/(VettoreSimd a, VettoreSimd b) { return {_mm256_div_ps(a.v, b.v)}; }
+};
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define SIMD_NOME "SSE"
+struct VettoreSimd
+{
+    static constexpr std::size_t LARGHEZZA = 4;
+    __m128 v;
+
+    static VettoreSimd zero() { return {_mm_setzero_ps()}; }
+    static VettoreSimd costante(float x) { return {_mm_set1_ps(x)}; }
+    static VettoreSimd carica(const float *p) { return {_mm_load_ps(p)}; }
+    static VettoreSimd componi(const float *p, std::size_t n)
+    {
+        return {_mm_setr_ps(p[0], n > 1 ? p[1] : 0.0f, n > 2 ? p[2] : 0.0f, n > 3 ? p[3] : 0.0f)};
+    }
+    void salva(float *p) const { _mm_store_ps(p, v); }
+    friend VettoreSimd operator+(VettoreSimd a, VettoreSimd b) { return {_mm_add_ps(a.v, b.v)}; }
+    friend VettoreSimd operator-(VettoreSimd a, VettoreSimd b) { return {_mm_sub_ps(a.v, b.v)}; }
+    friend VettoreSimd operator*(VettoreSimd a, VettoreSimd b) { return {_mm_mul_ps(a.v, b.v)}; }
+    friend VettoreSimd operator/(VettoreSimd a, VettoreSimd b) { return {_mm_div_ps(a.v, b.v)}; }
+};
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define SIMD_NOME "NEON"
+struct VettoreSimd
+{
+    static constexpr std::size_t LARGHEZZA = 4;
+    float32x4_t v;
+
+    static VettoreSimd zero() { return {vdupq_n_f32(0.0f)}; }
+    static VettoreSimd costante(float x) { return {vdupq_n_f32(x)}; }
+    static VettoreSimd carica(const float *p) { return {vld1q_f32(p)}; }
+    static VettoreSimd componi(const float *p, std::size_t n)
+    {
+        float32x4_t v = vdupq_n_f32(0.0f);
+        v = vsetq_lane_f32(p[0], v, 0);
+        if (n > 1)
+            v = vsetq_lane_f32(p[1], v, 1);
+        if (n > 2)
+            v = vsetq_lane_f32(p[2], v, 2);
+        if (n > 3)
+            v = vsetq_lane_f32(p[3], v, 3);
+        return {v};
+    }
+    void salva(float *p) const { vst1q_f32(p, v); }
+    friend VettoreSimd operator+(VettoreSimd a, VettoreSimd b) { return {vaddq_f32(a.v, b.v)}; }
+    friend VettoreSimd operator-(VettoreSimd a, VettoreSimd b) { return {vsubq_f32(a.v, b.v)}; }
+    friend VettoreSimd operator*(VettoreSimd a, VettoreSimd b) { return {vmulq_f32(a.v, b.v)}; }
+#if defined(__aarch64__)
+    friend VettoreSimd operator/(VettoreSimd a, VettoreSimd b) { return {vdivq_f32(a.v, b.v)}; }
+#else
+    // ARMv7 non ha la divisione vettoriale: stima del reciproco raffinata con due passi di Newton-Raphson
+    friend VettoreSimd operator/(VettoreSimd a, VettoreSimd b)
+    {
+        float32x4_t reciproco = vrecpeq_f32(b.v);
+        reciproco = vmulq_f32(vrecpsq_f32(b.v, reciproco), reciproco);
+        reciproco = vmulq_f32(vrecpsq_f32(b.v, reciproco), reciproco);
+        return {vmulq_f32(a.v, reciproco)};
+    }
+#endif
+};
+#else
+#define SIMD_NOME "scalare"
+struct VettoreSimd
+{
+    static constexpr std::size_t LARGHEZZA = 1;
+    float v;
+
+    static VettoreSimd zero() { return {0.0f}; }
+    static VettoreSimd costante(float x) { return {x}; }
+    static VettoreSimd carica(const float *p) { return {*p}; }
+    static VettoreSimd componi(const float *p, std::size_t) { return {*p}; }
+    void salva(float *p) const { *p = v; }
+    friend VettoreSimd operator+(VettoreSimd a, VettoreSimd b) { return {a.v + b.v}; }
+    friend VettoreSimd operator-(VettoreSimd a, VettoreSimd b) { return {a.v - b.v}; }
+    friend VettoreSimd operator*(VettoreSimd a, VettoreSimd b) { return {a.v * b.v}; }
+    friend VettoreSimd operator/(VettoreSimd a, VettoreSimd b) { return {a.v / b.v}; }
+};
+#endif
+
+// Allineamento in byte richiesto da carica/salva
+#define ALLINEAMENTO_SIMD (VettoreSimd::LARGHEZZA * sizeof(float))
+
+// Numero di elementi arrotondato al multiplo successivo della larghezza del registro
+constexpr std::size_t arrotondaLarghezzaSimd(std::size_t n)
+{
+    return (n + VettoreSimd::LARGHEZZA - 1) / VettoreSimd::LARGHEZZA * VettoreSimd::LARGHEZZA;
+}
+
+#endif
@@ -0,0 +1,197 @@
+/*
+    AUTOTUNE:
+
+    cerca i parametri del regolatore di progetto (PROGETTO_REGOLATORE in ProgettoRegolatore.hpp)
+        R(z) = gain * z (z - zero_1) / (z - pole_1)^2
+    su una griglia pole_1 x zero_1 x gain, simulando per ogni candidato lo scenario di ValutazioneRegolatore.hpp
+    sul modello identificato del Meca500. Ogni candidato è valutato con
+        costo = IAE + PESO_SOVRAELONGAZIONE * sovraelongazione + PESO_SATURAZIONE * frazione di campioni saturi
+    e i candidati che non convergono sono scartati, come quelli poco robusti (picco di sensibilità oltre
+    PICCO_SENSIBILITA_MASSIMO, calcolato con RispostaFrequenza prima della simulazione). La griglia è divisa tra i core con PoolThread.
+    Alla fine stampa i migliori candidati, con margini e picco di sensibilità (RispostaFrequenza.hpp), e la riga
+    da incollare in ProgettoRegolatore.hpp.
+
+    uso: autotune [punti_per_asse] [numero_thread]
+    default: 100 punti per asse (10^6 candidati), tutti i core
+*/
+
+#include <PoolThread.hpp>
+#include <ProgettoRegolatore.hpp>
+#include <RispostaFrequenza.hpp>
+#include <RegolatoreFisso.hpp>
+#include <ValutazioneRegolatore.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#define PUNTI_PER_ASSE_DEFAULT 100
+#define MIGLIORI_CANDIDATI 10
+#define DIMENSIONE_BLOCCO 256
+
+#define POLO_MINIMO 0.0
+#define POLO_MASSIMO 0.98
+#define ZERO_MINIMO 0.0
+#define ZERO_MASSIMO 0.98
+#define GUADAGNO_MINIMO 0.1
+#define GUADAGNO_MASSIMO 20.0
+
+#define PESO_SOVRAELONGAZIONE 1.0 // per mm
+#define PESO_SATURAZIONE 100.0    // per frazione di campioni saturi
+#define PICCO_SENSIBILITA_MASSIMO 2.0 // candidati con Ms maggiore scartati senza simularli (0 per disabilitare)
+
+using namespace std;
+
+// Regolatore di progetto: un numeratore del primo ordine e un denominatore del secondo
+using RegolatoreCandidato = RegolatoreFisso<1, 2, float>;
+
+struct Candidato
+{
+    float pole_1;
+    float zero_1;
+    float gain;
+    IndiciPrestazione indici;
+    double costo;
+};
+
+struct Griglia
+{
+    size_t punti;
+
+    double valore(size_t i, double minimo, double massimo) const
+    {
+        return (punti == 1) ? minimo : minimo + (massimo - minimo) * i / (punti - 1);
+    }
+
+    // Indice lineare -> parametri, il guadagno è campionato in scala logaritmica
+    Candidato candidato(size_t indice) const
+    {
+        size_t iGuadagno = indice % punti;
+        size_t iZero = (indice / punti) % punti;
+        size_t iPolo = indice / (punti * punti);
+        Candidato c;
+        c.pole_1 = valore(iPolo, POLO_MINIMO, POLO_MASSIMO);
+        c.zero_1 = valore(iZero, ZERO_MINIMO, ZERO_MASSIMO);
+        c.gain = exp(valore(iGuadagno, log(GUADAGNO_MINIMO), log(GUADAGNO_MASSIMO)));
+        return c;
+    }
+};
+
+void valuta(Candidato &c, const ConfigurazioneSimulazione &configurazione)
+{
+    RegolatoreCandidato regolatore({2 * c.pole_1, -c.pole_1 * c.pole_1}, {c.gain, -c.gain * c.zero_1});
+    c.indici = valutaRegolatore(regolatore, configurazione);
+    c.costo = c.indici.costo(PESO_SOVRAELONGAZIONE, PESO_SATURAZIONE);
+}
+
+// Mantiene in migliori i MIGLIORI_CANDIDATI a costo minore, in ordine crescente
+void inserisci(vector<Candidato> &migliori, const Candidato &c)
+{
+    if (!isfinite(c.costo) || (migliori.size() == MIGLIORI_CANDIDATI && c.costo >= migliori.back().costo))
+    {
+        return;
+    }
+    auto posizione = upper_bound(migliori.begin(), migliori.end(), c, [](const Candidato &a, const Candidato &b)
+                                 { return a.costo < b.costo; });
+    migliori.insert(posizione, c);
+    if (migliori.size() > MIGLIORI_CANDIDATI)
+    {
+        migliori.pop_back();
+    }
+}
+
+void stampa(const Candidato &c, RispostaFrequenza &rispostaFrequenza)
+{
+    MarginiStabilita margini = rispostaFrequenza.margini(
+        progetta(zeri{c.zero_1}, poli{c.pole_1, c.pole_1}, guadagno{c.gain}));
+    cout << fixed << setprecision(4) << setw(9) << c.pole_1 << setw(9) << c.zero_1 << setw(9) << c.gain
+         << setprecision(2) << setw(10) << c.indici.iae << setw(10) << c.indici.sovraelongazione << setw(10) << c.indici.saturazione
+         << setw(10) << c.indici.velocitaMassima << setw(10) << c.costo << setw(10) << margini.margineFase
+         << setw(10) << margini.margineGuadagno << setw(10) << margini.piccoSensibilita << endl;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t punti = (argc > 1) ? stoul(argv[1]) : PUNTI_PER_ASSE_DEFAULT;
+    size_t numeroThread = (argc > 2) ? stoul(argv[2]) : 0;
+    if (punti == 0)
+    {
+        cerr << "Il numero di punti per asse deve essere positivo" << endl;
+        return 1;
+    }
+
+    ConfigurazioneSimulazione configurazione;
+    Griglia griglia{punti};
+    const size_t numeroCandidati = punti * punti * punti;
+
+    PoolThread pool(numeroThread);
+    vector<vector<Candidato>> miglioriPerThread(pool.getNumeroThread());
+    vector<size_t> stabiliPerThread(pool.getNumeroThread(), 0);
+    vector<RispostaFrequenza> rispostePerThread(pool.getNumeroThread(), RispostaFrequenza(configurazione.meca500, configurazione.tempoCampionamento));
+
+    cout << "Valutazione di " << numeroCandidati << " candidati su " << pool.getNumeroThread() << " thread" << endl;
+    auto begin = chrono::steady_clock::now();
+    pool.parallelFor(numeroCandidati, DIMENSIONE_BLOCCO, [&](size_t inizio, size_t fine, size_t indiceThread)
+                     {
+                         vector<Candidato> &migliori = miglioriPerThread[indiceThread];
+                         for (size_t i = inizio; i < fine; i++)
+                         {
+                             Candidato c = griglia.candidato(i);
+                             if (PICCO_SENSIBILITA_MASSIMO > 0 &&
+                                 rispostePerThread[indiceThread].margini(progetta(zeri{c.zero_1}, poli{c.pole_1, c.pole_1}, guadagno{c.gain})).piccoSensibilita > PICCO_SENSIBILITA_MASSIMO)
+                             {
+                                 continue;
+                             }
+                             valuta(c, configurazione);
+                             stabiliPerThread[indiceThread] += c.indici.stabile;
+                             inserisci(migliori, c);
+                         } });
+    auto end = chrono::steady_clock::now();
+    double secondi = chrono::duration<double>(end - begin).count();
+
+    vector<Candidato> migliori;
+    size_t stabili = 0;
+    for (size_t t = 0; t < pool.getNumeroThread(); t++)
+    {
+        for (const Candidato &c : miglioriPerThread[t])
+        {
+            inserisci(migliori, c);
+        }
+        stabili += stabiliPerThread[t];
+    }
+
+    cout << setprecision(2) << fixed << "Tempo: " << secondi << " s (" << setprecision(0) << numeroCandidati / secondi
+         << " candidati/s, " << pool.getFurti() << " furti), candidati robusti e stabili: " << stabili << endl
+         << endl;
+
+    cout << setw(9) << "pole_1" << setw(9) << "zero_1" << setw(9) << "gain" << setw(10) << "IAE" << setw(10) << "sovr[mm]"
+         << setw(10) << "satur" << setw(10) << "|v|max" << setw(10) << "costo" << setw(10) << "PM[deg]"
+         << setw(10) << "GM[dB]" << setw(10) << "Ms" << endl;
+    RispostaFrequenza rispostaFrequenza(configurazione.meca500, configurazione.tempoCampionamento);
+    Candidato attuale{(float)PROGETTO_REGOLATORE.poli[0], (float)PROGETTO_REGOLATORE.zeri[0], (float)PROGETTO_REGOLATORE.guadagno, {}, 0};
+    valuta(attuale, configurazione);
+    cout << "regolatore attuale (PROGETTO_REGOLATORE):" << endl;
+    stampa(attuale, rispostaFrequenza);
+    cout << "migliori candidati:" << endl;
+    for (const Candidato &c : migliori)
+    {
+        stampa(c, rispostaFrequenza);
+    }
+
+    if (migliori.empty())
+    {
+        cout << "Nessun candidato stabile" << endl;
+        return 1;
+    }
+
+    const Candidato &c = migliori.front();
+    cout << endl
+         << "// ProgettoRegolatore.hpp" << endl
+         << setprecision(4)
+         << "inline constexpr ProgettoRegolatore<1, 2> PROGETTO_REGOLATORE = progetta(zeri{" << c.zero_1 << "}, poli{"
+         << c.pole_1 << ", " << c.pole_1 << "}, guadagno{" << c.gain << "});" << endl;
+    return 0;
+}
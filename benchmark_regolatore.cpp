@@ -0,0 +1,184 @@
+/*
+    BENCHMARK REGOLATORE:
+
+    misura il tempo medio per campione (ns/campione) di calculate_output per ordini da 1 a 10,
+    confrontando:
+        - l'implementazione originale con std::vector, spostamento degli stati e inner_product
+        - RegolatoreFisso<N, N, float> (std::array, buffer circolari, prodotti scalari srotolati)
+        - Regolatore, adattatore a tempo di esecuzione di RegolatoreFisso
+        - RegolatoreSos<(N + 1) / 2, float>, cascata di sezioni del secondo ordine
+
+    infine confronta la precisione della forma diretta e della cascata di sezioni in float
+    su un regolatore dell'ottavo ordine con poli vicini alla circonferenza unitaria
+
+    uso: benchmark_regolatore [numero_campioni]
+*/
+
+#include <Regolatore.hpp>
+#include <RegolatoreFisso.hpp>
+#include <SezioniSecondoOrdine.hpp>
+#include <Polinomi.hpp>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#define DEFAULT_NUM_SAMPLES 2000000
+
+using namespace std;
+
+// Implementazione originale, usata come termine di confronto
+class RegolatoreVettori
+{
+private:
+    vector<float> output_coefficients;
+    vector<float> input_coefficients;
+    vector<float> previous_inputs;
+    vector<float> previous_outputs;
+
+public:
+    RegolatoreVettori(vector<float> output_coeff, vector<float> input_coeff)
+        : output_coefficients(output_coeff), input_coefficients(input_coeff),
+          previous_inputs(input_coeff.size(), 0), previous_outputs(output_coeff.size(), 0) {}
+
+    float calculate_output(float input)
+    {
+        for (int i = previous_inputs.size() - 1; i > 0; i--)
+            previous_inputs[i] = previous_inputs[i - 1];
+        previous_inputs[0] = input;
+        float output = inner_product(previous_inputs.begin(), previous_inputs.end(), input_coefficients.begin(), 0.0);
+        output += inner_product(previous_outputs.begin(), previous_outputs.end(), output_coefficients.begin(), 0.0);
+        for (int i = previous_outputs.size() - 1; i > 0; i--)
+            previous_outputs[i] = previous_outputs[i - 1];
+        previous_outputs[0] = output;
+        return output;
+    }
+};
+
+volatile float sink; // impedisce al compilatore di eliminare il calcolo
+
+// Segnale di ingresso pseudo-casuale precalcolato, uguale per tutte le implementazioni
+vector<float> generateInput(size_t length)
+{
+    vector<float> input(length);
+    uint32_t seed = 12345;
+    for (auto &value : input)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        value = (float)(seed >> 8) / (float)(1u << 24) * 200.0f - 100.0f;
+    }
+    return input;
+}
+
+template <typename R>
+double nanosPerSample(R &regolatore, const vector<float> &input)
+{
+    float accumulator = 0;
+    auto begin = chrono::steady_clock::now();
+    for (float u : input)
+    {
+        accumulator += regolatore.calculate_output(u);
+    }
+    auto end = chrono::steady_clock::now();
+    sink = accumulator;
+    return chrono::duration<double, nano>(end - begin).count() / input.size();
+}
+
+template <size_t Order>
+void benchmarkOrder(const vector<float> &input)
+{
+    // Coefficienti stabili: la somma dei moduli dei coefficienti delle uscite è minore di 1
+    vector<float> input_coeff(Order + 1, 1.0f / (Order + 1));
+    vector<float> output_coeff(Order, 0.5f / Order);
+
+    array<float, Order + 1> input_array;
+    array<float, Order> output_array;
+    copy(input_coeff.begin(), input_coeff.end(), input_array.begin());
+    copy(output_coeff.begin(), output_coeff.end(), output_array.begin());
+
+    RegolatoreVettori vettori(output_coeff, input_coeff);
+    RegolatoreFisso<Order, Order, float> fisso(output_array, input_array);
+    Regolatore adattatore(output_coeff, input_coeff);
+    RegolatoreSos<(Order + 1) / 2, float> sezioni(convertiInSezioni(output_coeff, input_coeff));
+
+    cout << setw(8) << Order
+         << setw(16) << nanosPerSample(vettori, input)
+         << setw(16) << nanosPerSample(fisso, input)
+         << setw(16) << nanosPerSample(adattatore, input)
+         << setw(16) << nanosPerSample(sezioni, input) << endl;
+}
+
+// Errore massimo della forma diretta e della cascata di sezioni in float rispetto alla forma diretta in double
+void benchmarkPrecision(const vector<float> &input)
+{
+    // La forma diretta in float usa i coefficienti arrotondati a float, la cascata di sezioni è calcolata dai
+    // coefficienti in double: l'arrotondamento della forma diretta basta a rendere instabile questo regolatore
+    // Ottavo ordine: quattro coppie di poli con modulo 0.98 e quattro coppie di zeri con modulo 0.9, a bassa frequenza
+    vector<complex<double>> poli, zeri;
+    for (int i = 1; i <= 4; i++)
+    {
+        poli.push_back(polar(0.98, 0.05 * i));
+        poli.push_back(polar(0.98, -0.05 * i));
+        zeri.push_back(polar(0.9, 0.05 * i));
+        zeri.push_back(polar(0.9, -0.05 * i));
+    }
+    vector<complex<double>> denominatore = polinomioDaRadici(poli);
+    vector<complex<double>> numeratore = polinomioDaRadici(zeri);
+
+    // Coefficienti nel formato di Regolatore in doppia precisione, guadagno 0.01
+    vector<double> input_coeff, output_coeff;
+    for (size_t i = 0; i < numeratore.size(); i++)
+        input_coeff.push_back(0.01 * numeratore[i].real());
+    for (size_t i = 1; i < denominatore.size(); i++)
+        output_coeff.push_back(-denominatore[i].real());
+
+    RegolatoreFisso<8, 8, double> riferimento;
+    RegolatoreFisso<8, 8, float> fisso;
+    copy(input_coeff.begin(), input_coeff.end(), riferimento.coefficientiIngresso().begin());
+    copy(output_coeff.begin(), output_coeff.end(), riferimento.coefficientiUscita().begin());
+    copy(input_coeff.begin(), input_coeff.end(), fisso.coefficientiIngresso().begin());
+    copy(output_coeff.begin(), output_coeff.end(), fisso.coefficientiUscita().begin());
+    RegolatoreSos<4, float> sezioni(convertiInSezioni(output_coeff, input_coeff));
+
+    double erroreFisso = 0, erroreSezioni = 0, uscitaMassima = 0;
+    for (size_t k = 0; k < min(input.size(), (size_t)100000); k++)
+    {
+        double atteso = riferimento.calculate_output(input[k]);
+        erroreFisso = max(erroreFisso, fabs(fisso.calculate_output(input[k]) - atteso));
+        erroreSezioni = max(erroreSezioni, fabs(sezioni.calculate_output(input[k]) - atteso));
+        uscitaMassima = max(uscitaMassima, fabs(atteso));
+    }
+
+    cout << scientific << setprecision(3);
+    cout << "precisione ottavo ordine (uscita max " << uscitaMassima << "): errore max forma diretta float "
+         << erroreFisso << ", sezioni float " << erroreSezioni << endl;
+}
+
+template <size_t... Orders>
+void benchmarkOrders(const vector<float> &input, index_sequence<Orders...>)
+{
+    (benchmarkOrder<Orders + 1>(input), ...);
+}
+
+int main(int argc, char *argv[])
+{
+    size_t numSamples = DEFAULT_NUM_SAMPLES;
+    if (argc > 1)
+    {
+        numSamples = strtoul(argv[1], nullptr, 10);
+    }
+    vector<float> input = generateInput(numSamples);
+
+    cout << "ns/campione su " << numSamples << " campioni" << endl;
+    cout << fixed << setprecision(2);
+    cout << setw(8) << "ordine" << setw(16) << "vector" << setw(16) << "fisso" << setw(16) << "adattatore" << setw(16) << "sezioni" << endl;
+    benchmarkOrders(input, make_index_sequence<10>{});
+    benchmarkPrecision(input);
+
+    return 0;
+}
@@ -24,7 +24,7 @@ void CsvLogger::createDirectories(const std::string &path)
     namespace fs = std::filesystem;
 
     fs::path dirPath = fs::path(path).parent_path();
-    if (!fs::exists(dirPath))
+    if (!dirPath.empty() && !fs::exists(dirPath))
     {
         if (!fs::create_directories(dirPath))
         {
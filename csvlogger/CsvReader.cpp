@@ -0,0 +1,70 @@
+#include "CsvReader.hpp"
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+
+// Splits a csv row, ignoring the trailing separator written by CsvLogger::end_row
+static std::vector<std::string> split_row(const std::string &line)
+{
+    std::vector<std::string> tokens;
+    std::stringstream ss(line);
+    std::string token;
+    while (std::getline(ss, token, ','))
+    {
+        token.erase(0, token.find_first_not_of(" \r"));
+        token.erase(token.find_last_not_of(" \r") + 1);
+        if (!token.empty())
+        {
+            tokens.push_back(token);
+        }
+    }
+    return tokens;
+}
+
+CsvReader::CsvReader(const std::string filename)
+{
+    std::ifstream file(filename);
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Unable to open csv file " + filename);
+    }
+
+    std::string line;
+    std::getline(file, line);
+    header = split_row(line);
+    columns.resize(header.size());
+
+    while (std::getline(file, line))
+    {
+        std::vector<std::string> tokens = split_row(line);
+        if (tokens.size() < header.size())
+        {
+            continue; // incomplete row (e.g. interrupted logging)
+        }
+        for (size_t i = 0; i < header.size(); i++)
+        {
+            columns[i].push_back(std::stod(tokens[i]));
+        }
+    }
+}
+
+bool CsvReader::has_column(const std::string &name) const
+{
+    return std::find(header.begin(), header.end(), name) != header.end();
+}
+
+const std::vector<double> &CsvReader::column(const std::string &name) const
+{
+    auto it = std::find(header.begin(), header.end(), name);
+    if (it == header.end())
+    {
+        throw std::runtime_error("Missing csv column " + name);
+    }
+    return columns[it - header.begin()];
+}
+
+size_t CsvReader::rows() const
+{
+    return columns.empty() ? 0 : columns[0].size();
+}
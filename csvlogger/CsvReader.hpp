@@ -0,0 +1,21 @@
+#ifndef CSV_READER_H
+#define CSV_READER_H
+
+#include <string>
+#include <vector>
+
+// Reads a csv file with a header row (as written by CsvLogger) into memory, column by column
+class CsvReader
+{
+private:
+    std::vector<std::string> header;
+    std::vector<std::vector<double>> columns;
+
+public:
+    CsvReader(const std::string filename);
+    bool has_column(const std::string &name) const;
+    const std::vector<double> &column(const std::string &name) const;
+    size_t rows() const;
+};
+
+#endif
@@ -0,0 +1,120 @@
+/*
+    ERRORE DI QUANTIZZAZIONE:
+
+    confronta il regolatore di setupRegulator() in float con le versioni a virgola fissa Q15 e Q31
+    sulle sequenze di errore (riferimento - distanza misurata) registrate nei file csv del ciclo di controllo
+    e riporta l'errore massimo e quadratico medio sulla velocità comandata e il tempo per campione.
+
+    uso: errore_quantizzazione [file.csv ...]
+    senza argomenti usa dati_video/data*.csv
+*/
+
+#include <Regolatore.hpp>
+#include <ProgettoRegolatore.hpp>
+#include <RegolatoreVirgolaFissa.hpp>
+#include "csvlogger/CsvReader.hpp"
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+volatile float sink; // impedisce al compilatore di eliminare il calcolo
+
+struct Statistiche
+{
+    double erroreMassimo = 0;
+    double sommaQuadrati = 0;
+    double nanosPerCampione = 0;
+};
+
+// Errore dell'uscita di un regolatore rispetto a quella in float e tempo per campione
+template <typename R>
+Statistiche confronta(R regolatore, const vector<float> &errore, const vector<float> &atteso)
+{
+    Statistiche statistiche;
+    for (size_t k = 0; k < errore.size(); k++)
+    {
+        double differenza = regolatore.calculate_output(errore[k]) - atteso[k];
+        statistiche.erroreMassimo = max(statistiche.erroreMassimo, fabs(differenza));
+        statistiche.sommaQuadrati += differenza * differenza;
+    }
+
+    const int ripetizioni = 100;
+    float accumulatore = 0;
+    auto begin = chrono::steady_clock::now();
+    for (int r = 0; r < ripetizioni; r++)
+        for (float e : errore)
+            accumulatore += regolatore.calculate_output(e);
+    auto end = chrono::steady_clock::now();
+    sink = accumulatore;
+    statistiche.nanosPerCampione = chrono::duration<double, nano>(end - begin).count() / (ripetizioni * errore.size());
+    return statistiche;
+}
+
+int main(int argc, char *argv[])
+{
+    vector<string> files;
+    for (int i = 1; i < argc; i++)
+    {
+        files.push_back(argv[i]);
+    }
+    if (files.empty())
+    {
+        files = {"dati_video/data.csv", "dati_video/data2.csv", "dati_video/data3.csv", "dati_video/data4.csv", "dati_video/data5.csv"};
+    }
+
+    // Progetto del ciclo di controllo
+    vector<float> input_coeff(PROGETTO_REGOLATORE.input_coeff.begin(), PROGETTO_REGOLATORE.input_coeff.end());
+    vector<float> output_coeff(PROGETTO_REGOLATORE.output_coeff.begin(), PROGETTO_REGOLATORE.output_coeff.end());
+
+    RegolatoreVirgolaFissa<1, 2, Q15> q15(output_coeff, input_coeff);
+    RegolatoreVirgolaFissa<1, 2, Q31> q31(output_coeff, input_coeff);
+    cout << "fondo scala ingresso " << FONDO_SCALA_INGRESSO_DEFAULT << " mm, uscita " << FONDO_SCALA_USCITA_DEFAULT
+         << " mm/s, scala coefficienti Q15 2^" << q15.getScala() << ", Q31 2^" << q31.getScala() << endl;
+    cout << left << setw(26) << "file" << right << setw(10) << "campioni" << setw(12) << "|v| max"
+         << setw(14) << "Q15 max" << setw(14) << "Q15 rms" << setw(14) << "Q31 max" << setw(14) << "Q31 rms"
+         << setw(12) << "ns float" << setw(12) << "ns Q15" << setw(12) << "ns Q31" << endl;
+
+    double peggioreQ15 = 0, peggioreQ31 = 0;
+    for (const string &file : files)
+    {
+        CsvReader reader(file);
+        const vector<double> &reference = reader.column("reference");
+        const vector<double> &measured_distance = reader.column("measured_distance");
+        vector<float> errore(reader.rows());
+        for (size_t k = 0; k < errore.size(); k++)
+        {
+            errore[k] = reference[k] - measured_distance[k];
+        }
+
+        // Uscita di riferimento del regolatore in float
+        Regolatore regolatore(output_coeff, input_coeff);
+        vector<float> atteso(errore.size());
+        double velocitaMassima = 0;
+        for (size_t k = 0; k < errore.size(); k++)
+        {
+            atteso[k] = regolatore.calculate_output(errore[k]);
+            velocitaMassima = max(velocitaMassima, (double)fabs(atteso[k]));
+        }
+
+        regolatore.reset();
+        Statistiche statisticheFloat = confronta(regolatore, errore, atteso);
+        Statistiche statisticheQ15 = confronta(RegolatoreVirgolaFissa<1, 2, Q15>(output_coeff, input_coeff), errore, atteso);
+        Statistiche statisticheQ31 = confronta(RegolatoreVirgolaFissa<1, 2, Q31>(output_coeff, input_coeff), errore, atteso);
+        peggioreQ15 = max(peggioreQ15, statisticheQ15.erroreMassimo);
+        peggioreQ31 = max(peggioreQ31, statisticheQ31.erroreMassimo);
+
+        cout << left << setw(26) << file << right << setw(10) << errore.size() << setw(12) << setprecision(4) << velocitaMassima
+             << setw(14) << statisticheQ15.erroreMassimo << setw(14) << sqrt(statisticheQ15.sommaQuadrati / errore.size())
+             << setw(14) << statisticheQ31.erroreMassimo << setw(14) << sqrt(statisticheQ31.sommaQuadrati / errore.size())
+             << setw(12) << statisticheFloat.nanosPerCampione << setw(12) << statisticheQ15.nanosPerCampione
+             << setw(12) << statisticheQ31.nanosPerCampione << endl;
+    }
+
+    cout << "errore di quantizzazione massimo (mm/s): Q15 " << peggioreQ15 << ", Q31 " << peggioreQ31 << endl;
+    return 0;
+}
@@ -120,6 +120,13 @@ double Robot::get_position() // Returning x position of the Robot (horizontal)
     return pose[0];
 }
 
+RobotSnapshot Robot::snapshot()
+{
+    RobotSnapshot state;
+    meca500.getState(state);
+    return state;
+}
+
 void Robot::get_pose(float *x) // Returning pose, cartesian(mm) and angular(°)
 {
     meca500.getPose(x);
@@ -279,3 +286,29 @@ void Robot::move_lin_vel_trf(float velocity[6]) // input is in mm/s, ranging fro
     // vel[0] = (float)velocity;
     meca500.moveLinVelTRF(velocity);
 }
+
+void Robot::set_cycle_callback(void (*callback)(void *context, int64_t send_time, float x), void *context)
+{
+    // Waits for a running cycle_hook: afterwards the old callback and context are no longer used
+    master.setCycleHook(nullptr, nullptr);
+    cycle_callback = callback;
+    cycle_callback_context = context;
+    if (callback != nullptr)
+    {
+        master.setCycleHook(Robot::cycle_hook, this);
+    }
+}
+
+void Robot::cycle_hook(void *robot, int64 send_time)
+{
+    Robot *self = static_cast<Robot *>(robot);
+    CycleCallback callback = self->cycle_callback;
+    void *context = self->cycle_callback_context;
+    if (callback == nullptr)
+    {
+        return;
+    }
+    float pose[6];
+    self->meca500.getPose(pose);
+    callback(context, send_time, pose[0]);
+}
@@ -1,6 +1,7 @@
 #ifndef ROBOT_H
 #define ROBOT_H
 
+#include <atomic>
 #include <cstdint>
 #include <iostream>
 #include <iostream>
@@ -15,6 +16,9 @@
 
 // void get_joints_vel_with_jacobian(double velocity, float *joints, float *joints_vel);
 
+// Pose, joints, joint velocities, torques, status bits and DC time of one EtherCAT cycle (see Robot::snapshot)
+typedef sun::Meca500::State RobotSnapshot;
+
 class Robot
 {
 private:
@@ -35,6 +39,12 @@ private:
     const uint32_t TARGET_CYCLE_TIME_MICROSECONDS;
     char network_interface[50];
     static void update_data();
+
+    // Callback of set_cycle_callback, called by the EtherCAT thread through cycle_hook
+    typedef void (*CycleCallback)(void *context, int64_t send_time, float x);
+    std::atomic<CycleCallback> cycle_callback{nullptr};
+    std::atomic<void *> cycle_callback_context{nullptr};
+    static void cycle_hook(void *robot, int64 send_time);
     bool block_ended();
     bool movement_ended();
 
@@ -56,6 +66,8 @@ public:
     void set_conf(short c1, short c2, short c3);
 
     double get_position();
+    // Whole robot feedback copied with a single lock of the master: prefer it to several get_* calls per control cycle
+    RobotSnapshot snapshot();
     void get_pose(float *x);
     void print_pose();
     double get_velocity();
@@ -69,6 +81,11 @@ public:
     void move_lin(double x, double y, double z, double alpha, double beta, double gamma);
     void move_lin_rel_wrf(double x, double y, double z, double alpha, double beta, double gamma);
     void move_lin_vel_wrf(float velocity[6]);
+
+    // Calls callback at every EtherCAT cycle with the CLOCK_MONOTONIC time (ns) of ec_send_processdata and the
+    // x position just received; it runs in the real-time thread and must not block (nullptr removes it).
+    // It returns after any running call has finished: the previous context can then be read or freed
+    void set_cycle_callback(void (*callback)(void *context, int64_t send_time, float x), void *context);
 };
 
 #endif
\ No newline at end of file
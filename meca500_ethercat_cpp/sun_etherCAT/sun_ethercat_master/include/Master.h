@@ -28,6 +28,14 @@ namespace sun
     */
     class Master
     {
+    public:
+        /**
+         * Function called by the real-time thread once per cycle, after the process data exchange and outside the
+         * IO buffer mutex (it may call mutex_down/mutex_up).
+         * send_time is the CLOCK_MONOTONIC time (ns) just after ec_send_processdata.
+         */
+        typedef void (*CycleHook)(void *context, int64 send_time);
+
     private:
         char IOmap[4096]; /**< Buffer used by all slaves to write and read data */
         pthread_t tidm;
@@ -46,6 +54,9 @@ namespace sun
         void ec_sync(int64 reftime, int64 cycletime, int64 *offsettime);
         std::mutex mtx;
         std::thread thread_master;
+        std::mutex hookMtx; /**< Held by the real-time thread while the hook runs */
+        CycleHook cycleHook = nullptr;
+        void *cycleHookContext = nullptr;
 
     public:
         void deactivate();
@@ -179,6 +190,15 @@ namespace sun
          * Each slave has to call this method to release the IObuffer.
         */
         void mutex_up();
+
+        /**
+         * Installs the function called at every cycle of the real-time thread (nullptr removes it).
+         * It returns after any call of the previous hook has finished, so its context can be released afterwards;
+         * for the same reason it must not be called from inside the hook.
+         * @param CycleHook hook it runs in the real-time thread: it must not block.
+         * @param void* context passed back to the hook.
+        */
+        void setCycleHook(CycleHook hook, void *context);
     };
 
 } // namespace sun
@@ -210,11 +210,19 @@ namespace sun
             this->add_timespec(&ts, cycletime + toff);
             clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, &tleft);
 
+            struct timespec send_ts;
             mtx.lock();
             ec_send_processdata();
+            clock_gettime(CLOCK_MONOTONIC, &send_ts);
             wkc = ec_receive_processdata(EC_TIMEOUTRET);
             mtx.unlock();
 
+            // hookMtx is held while the hook runs, so setCycleHook returns only once the hook has finished
+            hookMtx.lock();
+            if (cycleHook != nullptr)
+                cycleHook(cycleHookContext, (int64)send_ts.tv_sec * NSEC_PER_SEC + send_ts.tv_nsec);
+            hookMtx.unlock();
+
             this->ec_sync(ec_DCtime, cycletime, &toff);
             time2 = ec_DCtime;
             cycle = time2 - time1;
@@ -317,4 +325,12 @@ namespace sun
     {
         mtx.unlock();
     }
+
+    void Master::setCycleHook(CycleHook hook, void *context)
+    {
+        hookMtx.lock();
+        cycleHook = hook;
+        cycleHookContext = context;
+        hookMtx.unlock();
+    }
 } // namespace sun
@@ -149,6 +149,23 @@ namespace sun
         uint32 cycletime;
 
     public:
+        /**
+         * Copy of the robot feedback taken from the process image in a single critical section:
+         * all fields belong to the same EtherCAT cycle. Aligned to a cache line so that a copy owned
+         * by one thread does not share lines with other data.
+        */
+        struct alignas(64) State
+        {
+            float pose[6];             /**< x, y, z [mm], alpha, beta, gamma [degrees] */
+            float joints[6];           /**< joint angles [degrees] */
+            float joint_velocities[6]; /**< joint velocities [degrees/s] */
+            float torques[6];          /**< joint torque ratios [%] */
+            uint16 status_bits;        /**< bit1=busy,2=activated,3=homed,4=simactivated */
+            uint16 error;
+            uint32 motion_bits;        /**< bit1=paused,2=EOB,3=EOM,4=FIFO_cleared,5=PStop */
+            int64 dc_time;             /**< distributed clock of the cycle that received the data [ns] */
+        };
+
         /**
          * meca_vector is a vector of all meca500 in the network
         */
@@ -184,6 +201,12 @@ namespace sun
          * @param float *joint_velocities: array contains the measured velocities.
         */
        void getJointsVelocities(float *joint_velocities);
+
+        /**
+         * This method copies pose, joints, joint velocities, torques, status bits and DC time with a single lock of the master.
+         * @param State &state: filled with the feedback of the last EtherCAT cycle.
+        */
+        void getState(State &state);
      
 
         /**
@@ -154,6 +154,23 @@ namespace sun
         joint_velocities[5] = out_MECA500->angular_velocities.joint_speed_6;
         master->mutex_up();
     }
+
+    void Meca500::getState(State &state)
+    {
+        static_assert(sizeof(cartesian_positiont) == sizeof(state.pose) && sizeof(angular_positiont) == sizeof(state.joints) &&
+                          sizeof(angular_velocitiest) == sizeof(state.joint_velocities) && sizeof(torque_ratiost) == sizeof(state.torques),
+                      "PDO layout does not match State");
+        master->mutex_down();
+        std::memcpy(state.pose, &out_MECA500->cartesian_position, sizeof(state.pose));
+        std::memcpy(state.joints, &out_MECA500->angular_position, sizeof(state.joints));
+        std::memcpy(state.joint_velocities, &out_MECA500->angular_velocities, sizeof(state.joint_velocities));
+        std::memcpy(state.torques, &out_MECA500->torque_ratio, sizeof(state.torques));
+        state.status_bits = out_MECA500->status_bits;
+        state.error = out_MECA500->error;
+        state.motion_bits = out_MECA500->motion_status.motion_bits;
+        state.dc_time = ec_DCtime;
+        master->mutex_up();
+    }
     
 
     /*
@@ -0,0 +1,190 @@
+/*
+    MONTECARLO:
+
+    verifica la robustezza del regolatore rispetto all'incertezza del modello del Meca500. Le due identificazioni
+    di robot_test_data (test_velocity_input_10_mm s e test_velocity_input_20_mm s) danno costante di tempo e
+    ritardo diversi da una prova all'altra: qui ogni campione estrae costanteTempo, ritardo e guadagno da
+    gaussiane centrate sui valori nominali di ParametriMeca500 (troncate a valori positivi), simula lo scenario
+    di ValutazioneRegolatore.hpp in anello chiuso con RegolatoreStatoSpazio (con anti-windup, come sul robot) e
+    ne raccoglie gli indici di prestazione. I campioni sono divisi tra i core con PoolThread a blocchi; ogni
+    campione ha il suo generatore (seme + indice) e il suo rumore del sensore, così il risultato non dipende
+    dal numero di thread.
+
+    Alla fine stampa la probabilità di instabilità (con intervallo di confidenza al 95%, Wilson) e i percentili
+    di sovraelongazione, tempo di assestamento, IAE e velocità massima sui campioni stabili, più i parametri
+    dei primi campioni instabili.
+
+    uso: montecarlo [campioni] [numero_thread] [{b0, b1, ...}{a1, a2, ...}]
+    default: 10000 campioni, tutti i core, coefficienti di PROGETTO_REGOLATORE (convenzione di --reg)
+*/
+
+#include <GruppiGraffe.hpp>
+#include <PoolThread.hpp>
+#include <ProgettoRegolatore.hpp>
+#include <RegolatoreStatoSpazio.hpp>
+#include <ValutazioneRegolatore.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#define CAMPIONI_DEFAULT 10000
+#define DIMENSIONE_BLOCCO 64
+#define SEME_MONTECARLO 0x5DEECE66Dull
+#define CAMPIONI_INSTABILI_STAMPATI 5
+
+// Deviazioni standard dell'incertezza sul modello, dell'ordine della differenza tra le due identificazioni
+#define DEVIAZIONE_COSTANTE_TEMPO 0.02 // s
+#define DEVIAZIONE_RITARDO 0.015       // s
+#define DEVIAZIONE_GUADAGNO 0.05       // relativa
+
+using namespace std;
+
+namespace
+{
+    struct Campione
+    {
+        ParametriMeca500 impianto;
+        IndiciPrestazione indici;
+    };
+
+    // Parametri estratti per il campione i: dipendono solo dall'indice, non dal thread che lo simula
+    ParametriMeca500 estrai(size_t i, const ParametriMeca500 &nominale)
+    {
+        mt19937_64 generatore(SEME_MONTECARLO + i);
+        normal_distribution<double> normale(0, 1);
+        ParametriMeca500 p = nominale;
+        p.costanteTempo = max(1e-3, nominale.costanteTempo + DEVIAZIONE_COSTANTE_TEMPO * normale(generatore));
+        p.ritardo = max(0.0, nominale.ritardo + DEVIAZIONE_RITARDO * normale(generatore));
+        p.guadagno = max(1e-3, nominale.guadagno * (1 + DEVIAZIONE_GUADAGNO * normale(generatore)));
+        return p;
+    }
+
+    // Percentile p (0-100) per selezione, senza ordinare tutto il vettore
+    double percentile(vector<double> valori, double p)
+    {
+        if (valori.empty())
+        {
+            return NAN;
+        }
+        size_t k = min(valori.size() - 1, (size_t)lround(p / 100 * (valori.size() - 1)));
+        nth_element(valori.begin(), valori.begin() + k, valori.end());
+        return valori[k];
+    }
+
+    void stampaPercentili(const string &nome, const vector<double> &valori)
+    {
+        cout << setw(22) << nome;
+        for (double p : {50.0, 90.0, 95.0, 99.0, 100.0})
+        {
+            cout << setw(10) << percentile(valori, p);
+        }
+        cout << endl;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    size_t numeroCampioni = (argc > 1) ? stoul(argv[1]) : CAMPIONI_DEFAULT;
+    size_t numeroThread = (argc > 2) ? stoul(argv[2]) : 0;
+    CoefficientiRegolatore coefficienti = coefficientiProgetto(PROGETTO_REGOLATORE);
+    if (argc > 3)
+    {
+        vector<vector<double>> gruppi;
+        try
+        {
+            gruppi = gruppiGraffe(argv[3]);
+        }
+        catch (const invalid_argument &e)
+        {
+            cerr << e.what() << endl;
+        }
+        if (gruppi.size() != 2 || gruppi[0].empty())
+        {
+            cerr << "Coefficienti non validi, formato: {b0, b1, ...}{a1, a2, ...}" << endl;
+            return 1;
+        }
+        coefficienti = {gruppi[1], gruppi[0]};
+    }
+    if (numeroCampioni == 0)
+    {
+        cerr << "Il numero di campioni deve essere positivo" << endl;
+        return 1;
+    }
+
+    const ConfigurazioneSimulazione nominale;
+    PoolThread pool(numeroThread);
+    vector<RegolatoreStatoSpazio> regolatoriPerThread(pool.getNumeroThread(),
+                                                      RegolatoreStatoSpazio(coefficienti.output_coeff, coefficienti.input_coeff));
+    vector<Campione> campioni(numeroCampioni);
+
+    cout << "Simulazione di " << numeroCampioni << " impianti su " << pool.getNumeroThread() << " thread" << endl;
+    auto begin = chrono::steady_clock::now();
+    pool.parallelFor(numeroCampioni, DIMENSIONE_BLOCCO, [&](size_t inizio, size_t fine, size_t indiceThread)
+                     {
+                         ConfigurazioneSimulazione configurazione = nominale;
+                         for (size_t i = inizio; i < fine; i++)
+                         {
+                             configurazione.meca500 = estrai(i, nominale.meca500);
+                             configurazione.sensore.seme = nominale.sensore.seme + i;
+                             campioni[i].impianto = configurazione.meca500;
+                             campioni[i].indici = valutaRegolatore(regolatoriPerThread[indiceThread], configurazione);
+                         } });
+    auto end = chrono::steady_clock::now();
+    double secondi = chrono::duration<double>(end - begin).count();
+
+    vector<double> sovraelongazione, assestamento, iae, velocita;
+    vector<const Campione *> instabili;
+    for (const Campione &c : campioni)
+    {
+        if (!c.indici.stabile)
+        {
+            instabili.push_back(&c);
+            continue;
+        }
+        sovraelongazione.push_back(c.indici.sovraelongazione);
+        assestamento.push_back(c.indici.tempoAssestamento);
+        iae.push_back(c.indici.iae);
+        velocita.push_back(c.indici.velocitaMassima);
+    }
+
+    // Intervallo di Wilson al 95% per la probabilità di instabilità
+    const double n = numeroCampioni, q = instabili.size() / n, z = 1.96;
+    const double centro = (q + z * z / (2 * n)) / (1 + z * z / n);
+    const double semiampiezza = z * sqrt(q * (1 - q) / n + z * z / (4 * n * n)) / (1 + z * z / n);
+
+    cout << setprecision(2) << fixed << "Tempo: " << secondi << " s (" << setprecision(0) << numeroCampioni / secondi
+         << " simulazioni/s, " << pool.getFurti() << " furti)" << endl;
+    cout << setprecision(3) << "Incertezza: T = " << nominale.meca500.costanteTempo << " +- " << DEVIAZIONE_COSTANTE_TEMPO
+         << " s, Tau = " << nominale.meca500.ritardo << " +- " << DEVIAZIONE_RITARDO << " s, guadagno = "
+         << nominale.meca500.guadagno << " +- " << DEVIAZIONE_GUADAGNO * 100 << "%" << endl;
+    cout << setprecision(4) << "Probabilità di instabilità: " << q * 100 << "% (" << instabili.size() << " su "
+         << numeroCampioni << ", 95%: " << max(0.0, centro - semiampiezza) * 100 << "% - "
+         << min(1.0, centro + semiampiezza) * 100 << "%)" << endl
+         << endl;
+
+    cout << setprecision(2) << setw(22) << "campioni stabili" << setw(10) << "P50" << setw(10) << "P90" << setw(10) << "P95"
+         << setw(10) << "P99" << setw(10) << "max" << endl;
+    stampaPercentili("sovraelongazione[mm]", sovraelongazione);
+    stampaPercentili("assestamento[s]", assestamento);
+    stampaPercentili("IAE[mm*s]", iae);
+    stampaPercentili("|v|max[mm/s]", velocita);
+
+    if (!instabili.empty())
+    {
+        cout << endl
+             << "Primi campioni instabili (T, Tau, guadagno):" << endl
+             << setprecision(4);
+        for (size_t i = 0; i < min<size_t>(CAMPIONI_INSTABILI_STAMPATI, instabili.size()); i++)
+        {
+            const ParametriMeca500 &p = instabili[i]->impianto;
+            cout << setw(10) << p.costanteTempo << setw(10) << p.ritardo << setw(10) << p.guadagno << endl;
+        }
+    }
+    return 0;
+}
@@ -18,7 +18,8 @@
 #include <iostream>
 #include <math.h>
 #include <chrono>
-#include <Regolatore.cpp>
+#include <ProgettoRegolatore.hpp>
+#include <EsecutorePeriodico.hpp>
 
 /*costants*/
 #define DEFAULT_SAMPLE_TIME 0.02               // sampling period in seconds
@@ -35,22 +36,10 @@ float m = 1;
 float q = 0;
 float Tc_s = DEFAULT_SAMPLE_TIME;
 
-Regolatore *regolatore = nullptr;
+RegolatoreFisso<1, 2> regolatore = make_regulator(PROGETTO_REGOLATORE);
 
 /*FUNCTIONS*/
 void menu(int n_par, char *par[]);             // manage user input from cmd
-uint64_t getCurrentTimeMicros();               // return current time in microseconds
-void delayMicroseconds(uint64_t microseconds); // pause execution
-
-void setupRegulator()
-{
-    float pole_1 = 0.6;
-    float zero_1 = 0.7967;
-    float gain = 1.6334;
-    vector<float> input_coeff{gain, -gain * zero_1};
-    vector<float> output_coeff{2 * pole_1, -pole_1 * pole_1};
-    regolatore = new Regolatore(output_coeff, input_coeff);
-}
 
 int main(int argc, char *argv[])
 {
@@ -59,8 +48,6 @@ int main(int argc, char *argv[])
     /*sensor setup*/
     sensor.useCalibrationCurve(m, q);
 
-    setupRegulator();
-
     /*robot, setup*/
     Robot robot(30, 200, 5000, "eth0", 0.0, 10);
     robot.reset_error();
@@ -74,9 +61,8 @@ int main(int argc, char *argv[])
     data_test.write("time,reference,position,measured_distance,error,velocity_control\n"); // if !take_data -> empy file
 
     /*time variables setup*/
-    uint64_t t0, start;
     float currentTime = 0;
-    uint64_t delayInterval;
+    EsecutorePeriodico executor(Tc_s); // absolute deadlines every Tc_s, late samples skip to the next deadline
 
     /*interpolation variables*/
     /*variable for interpolation
@@ -100,10 +86,9 @@ int main(int argc, char *argv[])
     float error;      // u[k]
     float output;      // y[k]
     /*control*/
+    executor.avvia();
     while (true)
     {
-        start = getCurrentTimeMicros();
-
         /*compute distance*/
         currentDistance = -sensor.getDistanceInMillimeters();
 
@@ -115,14 +100,13 @@ int main(int argc, char *argv[])
 
             /*stop Meca*/
             velocity[0] = 0;
-            regolatore->reset();
+            regolatore.reset();
             robot.move_lin_vel_wrf(velocity);
 
             /*wait for obstacle.*/
 
             while (currentDistance < -200)
             {
-                start = getCurrentTimeMicros();
                 currentDistance = -sensor.getDistanceInMillimeters();
 
                 /*export data*/
@@ -134,10 +118,9 @@ int main(int argc, char *argv[])
                 data_test << 0;
                 data_test.end_row();
 
-                /*compute dalay*/
-                delayInterval = Tc_s * 1e6 - (getCurrentTimeMicros() - start);
-                delayMicroseconds(delayInterval);
-                currentTime += Tc_s;
+                /*wait next deadline*/
+                executor.attendi();
+                currentTime = executor.getTempo();
             }
 
             cout << "Obstacle in range.. resuming control\n";
@@ -162,7 +145,7 @@ int main(int argc, char *argv[])
 
         /* computing */
         error = reference_distance - currentDistance;
-        output = regolatore->calculate_output(error);
+        output = regolatore.calculate_output(error);
 
         /* safety control: checking robot position limits */
         if (robot.get_position() >= robot.POS_LIMIT_SUP)
@@ -194,10 +177,9 @@ int main(int argc, char *argv[])
         data_test << output;
         data_test.end_row();
 
-        /*delay*/
-        delayInterval = Tc_s * 1e6 - (getCurrentTimeMicros() - start);
-        delayMicroseconds(delayInterval); // delay by time remaining
-        currentTime += Tc_s;          // increse time by Tc_s for reference smoothing
+        /*wait next deadline*/
+        executor.attendi();
+        currentTime = executor.getTempo(); // deadline time, skipped deadlines included, for reference smoothing
     }
 }
 
@@ -223,21 +205,3 @@ void menu(int n_par, char *par[])
         q = atof(par[3]);
     }
 }
-
-uint64_t getCurrentTimeMicros()
-{
-    return std::chrono::duration_cast<std::chrono::microseconds>(
-               std::chrono::system_clock::now().time_since_epoch())
-        .count();
-}
-
-void delayMicroseconds(uint64_t microseconds)
-{
-    auto start = std::chrono::high_resolution_clock::now();
-    auto end = start + std::chrono::microseconds(microseconds);
-
-    while (std::chrono::high_resolution_clock::now() < end)
-    {
-        // Busy-wait loop
-    }
-}
@@ -0,0 +1,134 @@
+/*
+    TABELLA GUADAGNI:
+
+    prepara offline la tabella del gain scheduling letta all'avvio da test_regolatore (GAIN_SCHEDULING).
+    Il file di calibrazione contiene una misura statica del sensore per ogni distanza vera dell'ostacolo
+    (colonne distance e measured_distance, in mm). La calibrazione lineare (useCalibrationCurve) corregge solo
+    la pendenza media m della caratteristica, ma la pendenza locale m(d) cambia con la distanza e con essa il
+    guadagno d'anello: per ogni distanza della griglia il guadagno di PROGETTO_REGOLATORE è scalato di m / m(d),
+    con zeri e poli invariati, così che il guadagno d'anello resti quello di progetto.
+
+    Ogni riga della tabella è un progetto a 50 Hz nella forma di PROGETTO_REGOLATORE:
+    distance, gain, zero_1 ... zero_m, pole_1 ... pole_n
+    e può essere modificata a mano o sostituita con progetti diversi per ogni distanza.
+
+    uso: tabella_guadagni calibrazione.csv [tabella.csv] [passo_mm]
+    default: tabella_guadagni.csv, passo 10 mm
+*/
+
+#include <ProgettoRegolatore.hpp>
+#include "csvlogger/CsvLogger.hpp"
+#include "csvlogger/CsvReader.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#define TABELLA_DEFAULT "tabella_guadagni.csv"
+#define PASSO_DEFAULT_mm 10.0
+
+using namespace std;
+
+// Pendenza ai minimi quadrati della retta misura = m * distanza + q sui punti indicati
+double pendenza(const vector<double> &distanza, const vector<double> &misura, const vector<size_t> &punti)
+{
+    double mediaD = 0, mediaM = 0;
+    for (size_t i : punti)
+    {
+        mediaD += distanza[i];
+        mediaM += misura[i];
+    }
+    mediaD /= punti.size();
+    mediaM /= punti.size();
+    double covarianza = 0, varianza = 0;
+    for (size_t i : punti)
+    {
+        covarianza += (distanza[i] - mediaD) * (misura[i] - mediaM);
+        varianza += (distanza[i] - mediaD) * (distanza[i] - mediaD);
+    }
+    return (varianza > 0) ? covarianza / varianza : NAN;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        cout << "uso: tabella_guadagni calibrazione.csv [tabella.csv] [passo_mm]" << endl;
+        return 1;
+    }
+    string fileTabella = (argc > 2) ? argv[2] : TABELLA_DEFAULT;
+    double passo = (argc > 3) ? stod(argv[3]) : PASSO_DEFAULT_mm;
+
+    CsvReader calibrazione(argv[1]);
+    const vector<double> &distanza = calibrazione.column("distance");
+    const vector<double> &misura = calibrazione.column("measured_distance");
+    vector<size_t> tutti(calibrazione.rows());
+    for (size_t i = 0; i < tutti.size(); i++)
+    {
+        tutti[i] = i;
+    }
+    const double pendenzaMedia = pendenza(distanza, misura, tutti);
+    if (!(pendenzaMedia > 0) || !(passo > 0))
+    {
+        cout << "Servono almeno due distanze diverse, una caratteristica crescente e un passo positivo" << endl;
+        return 1;
+    }
+    const double distanzaMinima = *min_element(distanza.begin(), distanza.end());
+    const double distanzaMassima = *max_element(distanza.begin(), distanza.end());
+    const size_t numeroPunti = (size_t)floor((distanzaMassima - distanzaMinima) / passo) + 1;
+
+    CsvLogger tabella(fileTabella);
+    tabella.write("distance,gain");
+    for (size_t i = 0; i < PROGETTO_REGOLATORE.zeri.size(); i++)
+    {
+        tabella.write(",zero_" + to_string(i + 1));
+    }
+    for (size_t i = 0; i < PROGETTO_REGOLATORE.poli.size(); i++)
+    {
+        tabella.write(",pole_" + to_string(i + 1));
+    }
+    tabella.write("\n");
+
+    cout << "pendenza media " << pendenzaMedia << ", " << numeroPunti << " punti da " << distanzaMinima << " mm" << endl;
+    cout << setw(12) << "distanza" << setw(12) << "pendenza" << setw(12) << "gain" << endl;
+    for (size_t p = 0; p < numeroPunti; p++)
+    {
+        // Pendenza locale sui punti entro un passo, allargando l'intorno se non bastano
+        const double d = distanzaMinima + p * passo;
+        double pendenzaLocale = NAN;
+        for (double raggio = passo; isnan(pendenzaLocale) && raggio <= 2 * (distanzaMassima - distanzaMinima) + passo; raggio *= 2)
+        {
+            vector<size_t> vicini;
+            for (size_t i = 0; i < distanza.size(); i++)
+            {
+                if (fabs(distanza[i] - d) <= raggio)
+                {
+                    vicini.push_back(i);
+                }
+            }
+            pendenzaLocale = pendenza(distanza, misura, vicini);
+        }
+        if (!(pendenzaLocale > 0))
+        {
+            cout << "Caratteristica del sensore non crescente a " << d << " mm: tabella non valida" << endl;
+            return 1;
+        }
+
+        double guadagno = PROGETTO_REGOLATORE.guadagno * pendenzaMedia / pendenzaLocale;
+        cout << fixed << setprecision(2) << setw(12) << d << setprecision(4) << setw(12) << pendenzaLocale << setw(12) << guadagno << endl;
+        tabella << d << guadagno;
+        for (double z : PROGETTO_REGOLATORE.zeri)
+        {
+            tabella << z;
+        }
+        for (double polo : PROGETTO_REGOLATORE.poli)
+        {
+            tabella << polo;
+        }
+        tabella.end_row();
+    }
+    cout << "Tabella scritta in " << fileTabella << endl;
+    return 0;
+}
@@ -1,16 +1,40 @@
 #include "distance_sensor/include/InfraredSensor.hpp"
 #include "meca500_ethercat_cpp/Robot.hpp"
 #include "csvlogger/CsvLogger.hpp"
-#include <Regolatore.cpp>
+#include "csvlogger/CsvReader.hpp"
+#include <Regolatore.hpp>
+#include <Discretizzazione.hpp>
+#include <ProgettoRegolatore.hpp>
+#include <RegolatoreStatoSpazio.hpp>
+#include <RegolatoreTempoVariabile.hpp>
+#include <StatisticheCampionamento.hpp>
+#include <TabellaGuadagni.hpp>
+#include <RispostaFrequenza.hpp>
+#include <ControlloPredittivo.hpp>
+#include <PredittoreSmith.hpp>
+#include <OsservatoreDisturbo.hpp>
+#include <StimatoreOstacolo.hpp>
+#include <EsperimentoRele.hpp>
+#include <ApprendimentoIterativo.hpp>
+#include <TriploBuffer.hpp>
+#include <EsecutorePeriodico.hpp>
+#include <AcquisizioneSensore.hpp>
+#include <TracciaLatenza.hpp>
+#include <CodaSpsc.hpp>
+#include <ServerComandi.hpp>
+#include <Polinomi.hpp>
+#include <GruppiGraffe.hpp>
 #include <vector>
 #include <unistd.h>
 #include <iostream>
 #include <math.h>
+#include <cmath>
 #include <chrono>
 #include <thread>
 #include <atomic>
 #include <string>
 #include <map>
+#include <memory>
 #include <cstring>
 #include <sstream>
 #include <iomanip>
@@ -21,17 +45,43 @@
 #define REFERENCE_COMMAND "rif"
 #define CALIBRATION_CURVE_COMMAND "cal"
 #define PAUSE_COMMAND "pause"
+#define REGULATOR_COMMAND "reg"
+#define MARGINS_COMMAND "margins"
+#define AUTOTUNE_COMMAND "autotune"
 
 // parametri per le descrizioni dei comandi
 #define optionWidth 60
 #define descriptionWidth 60
 #define message_length 30
+#define STABILITY_MARGIN 1e-3 // Distanza minima dei poli di --reg dal cerchio unitario (radici quadruple risolte da radiciPolinomio a ~1e-4)
+#define INTEGRATOR_TOLERANCE 1e-6 // Distanza massima da z = 1 del polo accettato come integratore (radice semplice)
 
 // parametri per il controllo
-#define SAMPLING_TIME 0.02         // Periodo di campionamento in secondi
-#define SAMPLING_TIME_MICROS 20000 // Periodi di campionamento in micro secondi
+#define SAMPLING_TIME 0.02                           // Periodo di campionamento in secondi
+#define SAMPLING_TIME_MICROS (std::lround(SAMPLING_TIME * 1e6)) // Periodo di campionamento in micro secondi
 #define DEFAULT_REFERENCE_mm -50   // Distanza di riferimento di default
 #define INTERPOLATION_DURATION 0.5 // Durata interpolazione riferimento in secondi
+#define VARIABLE_SAMPLING_TIME false // Regolatore a periodo variabile: ogni campione usa il periodo misurato
+#define GAIN_SCHEDULING false       // Regolatore interpolato a ogni campione dalla tabella in base alla distanza misurata
+#define GAIN_SCHEDULE_TABLE "tabella_guadagni.csv" // Tabella dei progetti per distanza (preparata con tabella_guadagni)
+#define MODEL_PREDICTIVE_CONTROL false // Controllo predittivo con vincoli di velocità, accelerazione e posizione al posto del regolatore
+#define SMITH_PREDICTOR false          // Predittore di Smith: il regolatore lavora con l'errore previsto a fine tempo morto
+#define DISTURBANCE_OBSERVER false     // Osservatore di disturbo: il moto stimato dell'ostacolo è compensato in avanti
+#define OBSTACLE_ESTIMATOR false       // Filtro di Kalman sull'ostacolo: distanza filtrata, velocità in avanti e brevi perdite del sensore attraversate
+#define ITERATIVE_LEARNING false       // Apprendimento iterativo: con l'ostacolo periodico la compensazione impara l'errore di ogni ciclo
+#define SENSOR_THREAD true             // Sensore letto in un thread dedicato: il ciclo usa l'ultima misura senza attendere la seriale
+#define SENSOR_TIMEOUT 0.1             // s, età oltre la quale la misura del thread è persa e l'ostacolo è trattato come fuori portata
+#define LATENCY_TRACE false            // Istanti di sensore, calcolo, PDO, invio EtherCAT e risposta del robot, riepilogati all'uscita
+#define OVERRUN_POLICY RITARDO_SALTA   // Campione oltre la scadenza successiva: RITARDO_SALTA, RITARDO_RECUPERA o RITARDO_INTERROMPI
+#define COMMAND_SOCKET "/tmp/regolatore.sock" // Socket UNIX per i comandi, stesso formato di stdin ("" solo stdin)
+#define COMMAND_POLL_TIMEOUT_ms 100    // Attesa massima del thread dei comandi prima di controllare isRunning
+#define COMMAND_QUEUE_SIZE 32          // Comandi in attesa del ciclo di controllo (potenza di 2)
+#define COMMANDS_PER_SAMPLE 4          // Comandi applicati al più in un campione
+
+// Il controllo predittivo sostituisce il regolatore lineare: la tabella dei guadagni non avrebbe effetto
+static_assert(!(GAIN_SCHEDULING && MODEL_PREDICTIVE_CONTROL), "GAIN_SCHEDULING non disponibile con MODEL_PREDICTIVE_CONTROL");
+// Osservatore e stimatore compensano entrambi il moto dell'ostacolo: insieme la velocità in avanti sarebbe sommata due volte
+static_assert(!(DISTURBANCE_OBSERVER && OBSTACLE_ESTIMATOR), "DISTURBANCE_OBSERVER e OBSTACLE_ESTIMATOR sono alternativi");
 
 using namespace std;
 
@@ -41,6 +91,9 @@ stringstream stopMessage;
 stringstream pauseMessage;
 stringstream refMessage;
 stringstream calMessage;
+stringstream regMessage;
+stringstream marginsMessage;
+stringstream autotuneMessage;
 
 // Struct per la gestione dei comandi
 struct OptionHandler
@@ -58,24 +111,126 @@ struct OptionHandler
 // Mappa contenente i comandi disponibili
 map<string, OptionHandler> optionHandlers;
 
-uint64_t getCurrentTimeMicros(); // ritorna il tempo attuale in microsecondi
+// Nuovi coefficienti del regolatore inviati dal thread dei comandi al ciclo di controllo
+struct RegulatorUpdate
+{
+    CoefficientiFissi coefficienti;
+    SezioniContinue sezioni; // Stesso regolatore per il periodo variabile (inversa di Tustin)
+    double fusione;          // 1 cambio bumpless, 0 stato mantenuto
+};
+
+/*
+    Regolatore lineare del ciclo di controllo, scelto una sola volta in setupRegulator: a periodo fisso
+    (RegolatoreStatoSpazio, coefficienti discretizzati a SAMPLING_TIME) o, con VARIABLE_SAMPLING_TIME, a periodo
+    variabile (RegolatoreTempoVariabile, integrato con il periodo misurato). Il ciclo usa solo questa interfaccia.
+*/
+class LoopRegulator
+{
+public:
+    virtual ~LoopRegulator() = default;
+
+    virtual float calculate_output(float input, double dt) = 0;
+    virtual void applica(float uscitaApplicata) = 0;
+    virtual void inizializza(float ingresso, float uscita) = 0;
+    // Coefficienti di --reg e --autotune
+    virtual void aggiorna(const RegulatorUpdate &update) = 0;
+    // Gain scheduling: regolatore interpolato alla distanza, con lo stato mantenuto
+    virtual void interpola(const TabellaGuadagni &tabella, double distanza) = 0;
+};
+
+class FixedPeriodRegulator : public LoopRegulator
+{
+private:
+    RegolatoreStatoSpazio regolatore;
+    CoefficientiFissi interpolati; // preallocati per il gain scheduling
+
+public:
+    explicit FixedPeriodRegulator(const CoefficientiRegolatore &coefficienti)
+        : regolatore(coefficienti.output_coeff, coefficienti.input_coeff) {}
+
+    // Il periodo è quello di progetto: dt non è usato
+    float calculate_output(float input, double dt) override { return regolatore.calculate_output(input); }
+    void applica(float uscitaApplicata) override { regolatore.applica(uscitaApplicata); }
+    void inizializza(float ingresso, float uscita) override { regolatore.inizializza(ingresso, uscita); }
+    void aggiorna(const RegulatorUpdate &update) override { regolatore.setCoefficienti(update.coefficienti, update.fusione); }
+    void interpola(const TabellaGuadagni &tabella, double distanza) override
+    {
+        tabella.interpola(distanza, interpolati);
+        regolatore.setCoefficienti(interpolati, 0);
+    }
+};
+
+class VariablePeriodRegulator : public LoopRegulator
+{
+private:
+    RegolatoreTempoVariabile regolatore;
+    SezioniContinue interpolate; // preallocate per il gain scheduling
+
+public:
+    VariablePeriodRegulator(const FunzioneTrasferimentoContinua &funzione, double tempoCampionamentoNominale)
+        : regolatore(funzione, tempoCampionamentoNominale) {}
+
+    float calculate_output(float input, double dt) override { return regolatore.calculate_output(input, dt); }
+    void applica(float uscitaApplicata) override { regolatore.applica(uscitaApplicata); }
+    void inizializza(float ingresso, float uscita) override { regolatore.inizializza(ingresso, uscita); }
+    void aggiorna(const RegulatorUpdate &update) override { regolatore.setSezioni(update.sezioni, update.fusione); }
+    void interpola(const TabellaGuadagni &tabella, double distanza) override
+    {
+        tabella.interpola(distanza, interpolate);
+        regolatore.setSezioni(interpolate, 0);
+    }
+};
+
+// Stato dell'esperimento a relè di --autotune, scambiato tra il thread dei comandi e il ciclo di controllo
+enum AutotuneState
+{
+    AUTOTUNE_IDLE,      // nessun esperimento
+    AUTOTUNE_REQUESTED, // richiesto dal thread dei comandi, parte al prossimo campione
+    AUTOTUNE_RUNNING,   // il relè sostituisce il regolatore
+    AUTOTUNE_DONE,      // ciclo limite misurato, risultato in relayExperiment
+    AUTOTUNE_FAILED     // durata massima superata, pausa o ostacolo fuori portata
+};
+
+// Comando che cambia lo stato del ciclo di controllo: il thread dei comandi lo accoda, il ciclo lo applica all'inizio del campione
+struct LoopCommand
+{
+    enum Type
+    {
+        REFERENCE,   // values[0]: distanza di riferimento finale (negativa)
+        CALIBRATION, // values[0], values[1]: m, q della curva di calibrazione
+        PAUSE,       // pausa o ripresa del controllo
+        STOP         // robot fermo e disattivato, fine del programma
+    };
+
+    Type type;
+    float values[2];
+};
+
+uint64_t getCurrentTimeMicros(); // ritorna il tempo attuale in microsecondi (orologio monotono)
+void measureSamplingTime();      // misura il periodo trascorso dal campione precedente
+bool waitForNextSample();        // attende la scadenza del prossimo campione, false se il ciclo è stato interrotto
+float readDistance();            // distanza misurata (negativa), aggiorna sensorRequestTime
 
 // Funzioni di inizializzazione
 void setup();
 void setupSensor();          // Setup del sensore
 void setupRobot();           // Setup del Meca500
 void setupRegulator();       // Setup regolatore
+void setupGainSchedule();    // Caricamento della tabella del gain scheduling
 void setupCsvLogger();       // Setup logger per i dati di controllo
 void setupHelpMessages();    // Setup per i messaggi dei comandi
 void setupCommandHandlers(); // Setup dei comandi
 
 // Funzioni per il parsing dei comandi
 vector<std::string> splitString(const string &input);
-map<string, string> parseOptionTokens(int argc, char *argv[]);
+map<string, string> parseOptionTokens(const vector<string> &tokens);
 vector<float> parseStringToVector(string input);
 
-// Funzione per l'esecuzione dei comandi ricevuti
-int executeOptions(map<string, string> options);
+// Funzioni per l'esecuzione dei comandi ricevuti
+string executeCommandLine(const string &line);  // riga da stdin o dal socket, ritorna le risposte
+string executeOptions(map<string, string> options);
+bool sendLoopCommand(const LoopCommand &command); // accoda il comando per il ciclo di controllo, false se la coda è piena
+void applyLoopCommands();                         // ciclo di controllo: applica al più COMMANDS_PER_SAMPLE comandi accodati
 
 // Handlers dei singoli comandi
 string handleHelp(string value);
@@ -83,6 +238,12 @@ string handleStop(string value);
 string handlePause(string value);
 string handleRef(string value);
 string handleCalibration(string value);
+string handleRegulator(string value);
+string handleMargins(string value);
+string handleAutotune(string value);
+string finishAutotune(); // thread dei comandi: taratura alla fine dell'esperimento a relè
+string checkRegulatorPoles(const vector<double> &outputCoeff); // motivo del rifiuto dei poli di --reg e --autotune, vuoto se accettati
+void failAutotune();     // ciclo di controllo: interrompe l'esperimento richiesto o in corso
 
 // Funzioni del ciclo di controllo
 void handleOutOfRange();                                // Funzione che gestisce l'ostacolo fuori portata del sensore
@@ -91,18 +252,35 @@ void moveRobotToPosition(vector<float> robot_position); // Wrapper del metodo Ro
 void writeDataToCsv(float time, float reference, float position, float measured_distance, float error, float velocity_control, CsvLogger &logger);
 
 void controlLoop();   // Ciclo di controllo
-void receiveCommands(); // Ciclo di ricezione dei comandi
+void receiveCommands(); // Ciclo di ricezione dei comandi da stdin e dal socket
 
 std::atomic<float> finalReferenceDistance(DEFAULT_REFERENCE_mm); // Distanza di riferimento scelta
 std::atomic<bool> isRunning(true);                                  // Flag per l'esecuzione del programma
-std::atomic<bool> controlLoopActive(true);                          // Flag per l'esecuzione del ciclo di controllo
+std::atomic<bool> controlLoopActive(true);                          // Flag per l'esecuzione del ciclo di controllo (scritto dal ciclo)
+CodaSpsc<LoopCommand, COMMAND_QUEUE_SIZE> loopCommands;            // Unico produttore il thread dei comandi, unico consumatore il ciclo
 
 InfraredSensor *infraredSensor = nullptr; // Puntatore all'oggetto per la gestione del sensore
+AcquisizioneSensore *sensorAcquisition = nullptr; // Thread di acquisizione usato con SENSOR_THREAD
 Robot *robot = nullptr;                   // Puntatore all'oggetto per la gestione del Meca500
-Regolatore *regolatore = nullptr;         // Puntatore all'oggetto regolatore
+LoopRegulator *regolatore = nullptr;                          // Regolatore lineare (periodo fisso o VARIABLE_SAMPLING_TIME)
+ControlloPredittivo *controlloPredittivo = nullptr;           // Controllo usato con MODEL_PREDICTIVE_CONTROL
+PredittoreSmith *predittoreSmith = nullptr;                   // Predittore usato con SMITH_PREDICTOR
+OsservatoreDisturbo *osservatoreDisturbo = nullptr;           // Osservatore usato con DISTURBANCE_OBSERVER
+StimatoreOstacolo *stimatoreOstacolo = nullptr;               // Filtro usato con OBSTACLE_ESTIMATOR
+ApprendimentoIterativo *apprendimentoIterativo = nullptr;     // Apprendimento usato con ITERATIVE_LEARNING
+TracciaLatenza *latencyTrace = nullptr;                       // Tracciamento usato con LATENCY_TRACE
+EsperimentoRele *relayExperiment = nullptr;                   // Esperimento a relè di --autotune
+std::atomic<AutotuneState> autotuneState(AUTOTUNE_IDLE);     // Fase dell'esperimento a relè
+RegolaTaratura autotuneRule = TARATURA_PD;                    // Regola scelta da --autotune (solo thread dei comandi)
 CsvLogger *csvLogger = nullptr;              // Puntatore all'oggetto per il logging dei dati
+TriploBuffer<RegulatorUpdate> regulatorUpdates; // Coefficienti pubblicati da --reg, letti dal ciclo di controllo senza lock
+TabellaGuadagni *gainSchedule = nullptr;        // Tabella del gain scheduling, caricata all'avvio con GAIN_SCHEDULING
+std::atomic<bool> gainSchedulingActive(false);  // Gain scheduling in uso (disattivato dai coefficienti di --reg)
+CoefficientiFissi activeCoefficients;           // Ultimi coefficienti impostati (setup o --reg), usati da --margins
 
 float currentDistance; // Variabile contente la distanza attuale misurata
+RobotSnapshot robotState;  // Stato del Meca500 letto una sola volta per campione (Robot::snapshot)
+float robotPosition = 0;   // Posizione x del robot nel campione attuale, da robotState
 
 float currentReferenceDistance = DEFAULT_REFERENCE_mm;                                                            // Distanza di riferimento attuale per l'interpolazione
 bool interpolationActive = true;                                                                                  // Flag per l'interpolazione del riferimento
@@ -110,15 +288,25 @@ float startingReferenceDistance = 0;
 float interpolationDuration = INTERPOLATION_DURATION;                                                                                   // Durata dell'interpolazione del riferimento in secondi
 float interpolationSlope = (finalReferenceDistance - startingReferenceDistance) / interpolationDuration; // Pendenza della retta interpolante
 float interpolationTime = 0;                                                                                      // Istante iniziale per l'inizio dell'interpolazione
+bool regulatorRestart = false;                                                                                    // Flag per la ripartenza bumpless del regolatore
 bool obstacleOutOfRange = false;                                                                                          // Flag ostacolo fuori portata
 
 uint64_t start;         // Istante di inizio controllo
+uint64_t lastSampleStart = 0; // Istante di inizio del campione precedente, 0 se non disponibile
+uint64_t sensorRequestTime = 0; // Istante della richiesta della misura al sensore nel campione attuale
+uint64_t sensorReplyTime = 0;   // Istante della risposta del sensore nel campione attuale
+bool firstSample = true;      // Flag per il primo campione
+float samplingTime = SAMPLING_TIME; // Periodo misurato dell'ultimo campione in secondi
+StatisticheCampionamento samplingTimeStats(SAMPLING_TIME); // Statistiche del periodo misurato
+EsecutorePeriodico controlExecutor(SAMPLING_TIME, {OVERRUN_POLICY}); // Scadenze assolute dei campioni e istogrammi del jitter
 float current_time = 0; // Tempo attuale in secondi
 uint64_t delayDuration;    // Tempo di attesa in microsecondi
 
 float velocity[] = {0, 0, 0, 0, 0, 0}; // Vettore per le velocità del Meca500
 
 float error = 0;  // Errore tra riferimento e distanza misurata
+float regulatorError = 0; // Errore passato al regolatore (previsto a fine tempo morto con SMITH_PREDICTOR)
+float compensation = 0;    // Velocità in avanti (osservatore, stimatore, apprendimento) sommata all'uscita del regolatore
 float output = 0; // Iutput del regolatore
 
 string csvDataPath; // Percorso per il salvataggio dei dati di controllp
@@ -137,6 +325,13 @@ int main(int argc, char const *argv[])
     }
     // Inizializzazione delle variabili
     setup();
+    if (SENSOR_THREAD)
+    {
+        // Il ciclo di controllo parte con una misura già disponibile
+        sensorAcquisition->avvia();
+        while (!sensorAcquisition->aggiorna())
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
     // Creazione ed esecuzione dei thread
     std::thread controlLoopThread(controlLoop);
     std::thread riceviOpzioniThread(receiveCommands);
@@ -144,6 +339,8 @@ int main(int argc, char const *argv[])
     // Aspetta che entrambi i thread terminino l'esecuzione
     controlLoopThread.join();
     riceviOpzioniThread.join();
+    if (SENSOR_THREAD)
+        sensorAcquisition->ferma();
 
     return 0;
 }
@@ -152,27 +349,73 @@ void controlLoop()
 {
     cout << "Starting control loop" << endl;
 
+    controlExecutor.avvia();
     while (isRunning)
     {
+        /* Comandi ricevuti (riferimento, calibrazione, pausa, stop): costo limitato a COMMANDS_PER_SAMPLE per campione */
+        applyLoopCommands();
+        if (!isRunning)
+            break;
+
         /* Controlla se il controllo è attivo */
         if (!controlLoopActive)
         {
             velocity[0] = 0;
             robot->move_lin_vel_wrf(velocity);
             delayDuration = SAMPLING_TIME_MICROS;
+            // In pausa arrivano solo la ripresa o lo stop
             while (!controlLoopActive)
+            {
                 std::this_thread::sleep_for(std::chrono::microseconds(delayDuration));
+                applyLoopCommands();
+            }
+            if (!isRunning)
+                break;
+            // Il robot è rimasto fermo: il regolatore riparte dalla velocità nulla
+            regulatorRestart = true;
+            // La pausa interrompe l'esperimento a relè, anche se richiesto e non ancora partito
+            failAutotune();
+            // L'ostacolo può essersi spostato durante la pausa: la stima riparte dalla prossima misura
+            if (OBSTACLE_ESTIMATOR)
+                stimatoreOstacolo->reset();
+            // Il ciclo dell'ostacolo non è più in fase con la compensazione appresa
+            if (ITERATIVE_LEARNING)
+                apprendimentoIterativo->reset();
+            // La pausa non è un periodo di campionamento: le scadenze ripartono da adesso
+            lastSampleStart = 0;
+            controlExecutor.avvia();
         }
-        start = getCurrentTimeMicros();
+        measureSamplingTime();
+
+        /* Nuovi coefficienti del regolatore: cambio all'inizio del periodo, senza lock né allocazioni */
+        if (regulatorUpdates.aggiorna())
+        {
+            regolatore->aggiorna(regulatorUpdates.lettura());
+            // I coefficienti scelti dall'utente sostituiscono quelli della tabella
+            gainSchedulingActive = false;
+        }
+
+        /* Misura la distanza attuale tra sensore e ostacolo e stato del robot (un solo accesso al process image) */
+        currentDistance = readDistance();
+        robotState = robot->snapshot();
+        robotPosition = robotState.pose[0];
 
-        /* Misura la distanza attuale tra sensore e ostacolo */
-        currentDistance = -infraredSensor->getDistanceInMillimeters();
+        /* Stima dell'ostacolo: senza misura valida il filtro prosegue con la predizione finché la stima lo consente */
+        if (OBSTACLE_ESTIMATOR)
+        {
+            stimatoreOstacolo->passo(currentDistance, robotPosition, currentDistance >= -200, samplingTime);
+            if (stimatoreOstacolo->isValida())
+                currentDistance = stimatoreOstacolo->getDistanza(robotPosition);
+        }
         startingReferenceDistance = currentDistance;
 
         /* Ostacolo fuori portata del sensore */
         if (currentDistance < -200)
         {
             handleOutOfRange();
+            // Ciclo interrotto (stop o scadenza persa) mentre si aspettava l'ostacolo
+            if (!isRunning)
+                break;
         }
 
         /* Interpolazione del riferimento se necessario */
@@ -181,12 +424,73 @@ void controlLoop()
             interpolateReference();
         }
 
+        /* Gain scheduling: regolatore interpolato alla distanza attuale, con lo stato mantenuto */
+        if (gainSchedulingActive)
+        {
+            regolatore->interpola(*gainSchedule, -currentDistance);
+        }
+
         /* Calcolo dell'errore e della velocità da comandare */
         error = currentReferenceDistance - currentDistance;
-        output = regolatore->calculate_output(error);
+        regulatorError = error;
+        if (SMITH_PREDICTOR && !MODEL_PREDICTIVE_CONTROL)
+        {
+            // Errore previsto a fine tempo morto (il controllo predittivo ha già il ritardo nel suo modello)
+            if (regulatorRestart)
+                predittoreSmith->reset();
+            regulatorError = predittoreSmith->correggi(error);
+        }
+        if (regulatorRestart)
+        {
+            // Ripartenza bumpless: stato del regolatore coerente con l'ultima velocità inviata (nulla dopo pausa e
+            // ostacolo fuori portata, l'uscita del relè alla fine dell'esperimento) e con l'errore attuale
+            if (MODEL_PREDICTIVE_CONTROL)
+                controlloPredittivo->inizializza(regulatorError, velocity[0]);
+            else
+                regolatore->inizializza(regulatorError, velocity[0]);
+            if (DISTURBANCE_OBSERVER)
+                osservatoreDisturbo->reset(currentDistance, robotPosition);
+            regulatorRestart = false;
+        }
+
+        /* Esperimento a relè di --autotune: il relè sostituisce il regolatore finché il ciclo limite non è misurato */
+        if (autotuneState == AUTOTUNE_REQUESTED)
+        {
+            relayExperiment->reset();
+            autotuneState = AUTOTUNE_RUNNING;
+        }
+        bool relayActive = (autotuneState == AUTOTUNE_RUNNING);
+        if (relayActive)
+        {
+            // Relè sull'errore misurato: l'esperimento identifica l'anello reale, con tutti i suoi ritardi
+            output = relayExperiment->uscita(error, samplingTime);
+            if (relayExperiment->getStato() != EsperimentoRele::IN_CORSO)
+            {
+                // Il regolatore riparte dall'ultima uscita del relè, i nuovi coefficienti arrivano da finishAutotune
+                regulatorRestart = true;
+                autotuneState = (relayExperiment->getStato() == EsperimentoRele::COMPLETATO) ? AUTOTUNE_DONE : AUTOTUNE_FAILED;
+                // La compensazione appresa vale per il regolatore precedente e per una storia interrotta dal relè
+                if (ITERATIVE_LEARNING)
+                    apprendimentoIterativo->reset();
+            }
+        }
+        else if (MODEL_PREDICTIVE_CONTROL)
+            output = controlloPredittivo->calculate_output(regulatorError, robotPosition);
+        else
+            output = regolatore->calculate_output(regulatorError, samplingTime);
+
+        /* Compensazione in avanti del disturbo stimato (moto dell'ostacolo) */
+        compensation = 0;
+        if (DISTURBANCE_OBSERVER && !relayActive)
+            compensation += osservatoreDisturbo->compensazione(currentDistance, robotPosition);
+        if (OBSTACLE_ESTIMATOR && !relayActive)
+            compensation += stimatoreOstacolo->getVelocita(); // il robot segue l'ostacolo alla sua velocità
+        if (ITERATIVE_LEARNING && !relayActive)
+            compensation += apprendimentoIterativo->compensazione(error, robotPosition - currentDistance);
+        output += compensation;
 
         /* Controllo delle posizioni limite ammesse */
-        if (robot->get_position() >= robot->POS_LIMIT_SUP)
+        if (robotPosition >= robot->POS_LIMIT_SUP)
         {
             // se la velocità è positiva resta fermo
             if (output > 0)
@@ -194,7 +498,7 @@ void controlLoop()
                 output = 0;
             }
         }
-        else if (robot->get_position() <= robot->POS_LIMIT_INF)
+        else if (robotPosition <= robot->POS_LIMIT_INF)
         {
             // se la velocità è negativa resta fermo
             if (output < 0)
@@ -203,20 +507,46 @@ void controlLoop()
             }
         }
 
+        /* Anti-windup: il regolatore aggiorna lo stato con la velocità effettivamente inviata (senza la compensazione) */
+        if (relayActive)
+        {
+            // Uscita del relè: il regolatore viene inizializzato alla fine dell'esperimento
+        }
+        else if (MODEL_PREDICTIVE_CONTROL)
+            controlloPredittivo->applica(output - compensation);
+        else
+            regolatore->applica(output - compensation);
+        if (DISTURBANCE_OBSERVER)
+            osservatoreDisturbo->applica(output);
+        if (SMITH_PREDICTOR && !MODEL_PREDICTIVE_CONTROL)
+        {
+            // Tempo morto aggiornato con l'età della misura all'invio del comando, oltre al ritardo interno del Meca500
+            predittoreSmith->applica(output);
+            predittoreSmith->aggiornaRitardo(ParametriMeca500().ritardo + (getCurrentTimeMicros() - sensorRequestTime) * 1e-6);
+        }
+
         /* Invia la velocità calcolata al Meca500 */
+        uint64_t computeTime = getCurrentTimeMicros();
         velocity[0] = output;
         robot->move_lin_vel_wrf(velocity);
+        if (LATENCY_TRACE)
+            latencyTrace->registra(sensorRequestTime * 1000, sensorReplyTime * 1000, computeTime * 1000, output);
 
         /* Scrivi dati di controllo sul file csv */
         // "time,reference,position,measured_distance,error,velocity_control"
-        writeDataToCsv(current_time, currentReferenceDistance, robot->get_position(), currentDistance, error, output, *csvLogger);
+        writeDataToCsv(current_time, currentReferenceDistance, robotPosition, currentDistance, error, output, *csvLogger);
 
-        /* Aspetta il tempo di campionamento corretto */
-        delayDuration = SAMPLING_TIME_MICROS - (getCurrentTimeMicros() - start);
-        std::this_thread::sleep_for(std::chrono::microseconds(delayDuration));
+        /* Aspetta la scadenza del prossimo campione */
+        waitForNextSample();
+    }
 
-        // Incremento il tempo attuale
-        current_time += SAMPLING_TIME;
+    samplingTimeStats.stampa(cout);
+    controlExecutor.stampa(cout);
+    if (LATENCY_TRACE)
+    {
+        // Ritorna dopo l'eventuale chiamata in corso del thread EtherCAT: da qui la traccia non è più scritta
+        robot->set_cycle_callback(nullptr, nullptr);
+        latencyTrace->stampa(cout);
     }
 }
 
@@ -225,31 +555,47 @@ void handleOutOfRange()
     cout << "Sensor out of range.. stopping robot\n";
     cout << "Waiting for obstacle to be in range..\n";
 
+    // Senza misura il ciclo limite non è più valido, e non può partire
+    failAutotune();
+
     /* Ferma il Meca500 */
     velocity[0] = 0;
-    regolatore->reset();
     robot->move_lin_vel_wrf(velocity);
 
     /* Aspetta che l'ostacolo torni all'interno della portata del sensore */
-    while (currentDistance < -200)
+    while (currentDistance < -200 && isRunning)
     {
-        start = getCurrentTimeMicros();
-        currentDistance = -infraredSensor->getDistanceInMillimeters();
+        applyLoopCommands();
+        measureSamplingTime();
+        currentDistance = readDistance();
+        robotState = robot->snapshot();
+        robotPosition = robotState.pose[0];
 
         /* Scrivi i dati di controllo sul file csv */
-        writeDataToCsv(current_time, currentReferenceDistance, robot->get_position(), currentDistance, finalReferenceDistance - currentDistance, 0, *csvLogger);
+        writeDataToCsv(current_time, currentReferenceDistance, robotPosition, currentDistance, finalReferenceDistance - currentDistance, 0, *csvLogger);
 
-        /* Aspetta il tempo di campionamento corretto */
-        delayDuration = SAMPLING_TIME * 1e6 - (getCurrentTimeMicros() - start);
-        std::this_thread::sleep_for(std::chrono::microseconds(delayDuration));
-        current_time += SAMPLING_TIME;
+        /* Aspetta la scadenza del prossimo campione */
+        if (!waitForNextSample())
+            return;
     }
 
     cout << "Obstacle in range.. resuming control\n";
 
+    // La stima precedente non è più valida: il filtro riparte dalla prossima misura
+    if (OBSTACLE_ESTIMATOR)
+    {
+        stimatoreOstacolo->reset();
+    }
+    // Storia dell'ostacolo interrotta: il periodo va riconosciuto di nuovo
+    if (ITERATIVE_LEARNING)
+    {
+        apprendimentoIterativo->reset();
+    }
+
     /* L'ostacolo è tornato all'interno della portata del sensore */
-    // È necessaria un'altra interpolazione
+    // È necessaria un'altra interpolazione e il regolatore riparte dal robot fermo
     interpolationActive = true;
+    regulatorRestart = true;
 }
 
 void interpolateReference()
@@ -271,32 +617,67 @@ void interpolateReference()
     }
 }
 
-// Funzione che riceve continuamente i comandi dall'utente per eseguirli
+// Funzione che riceve i comandi da stdin e dal socket e li esegue, senza bloccare oltre COMMAND_POLL_TIMEOUT_ms
 void receiveCommands()
 {
-    string input;
-    // Pulisci l'ingresso
-    cin.clear();
-    fflush(stdin);
+    // Un solo thread legge tutti gli ingressi: è l'unico produttore della coda dei comandi
+    unique_ptr<ServerComandi> server;
+    try
+    {
+        server.reset(new ServerComandi(COMMAND_SOCKET));
+    }
+    catch (const exception &e)
+    {
+        cerr << e.what() << ", comandi solo da stdin" << endl;
+        server.reset(new ServerComandi(""));
+    }
 
+    cout << "Inserisci comandi da eseguire --commandname=commandvalue [--help]" << endl;
     while (isRunning)
     {
-        cout << "Inserisci comandi da eseguire --commandname=commandvalue [--help]: " << endl;
-        getline(std::cin, input);
+        server->servi(COMMAND_POLL_TIMEOUT_ms, executeCommandLine);
+
+        // Esperimento a relè concluso: taratura e nuovi coefficienti qui, fuori dal ciclo di controllo
+        AutotuneState state = autotuneState;
+        if (state == AUTOTUNE_DONE || state == AUTOTUNE_FAILED)
+            cout << finishAutotune() << flush;
+    }
+}
 
-        // Esegui il parsing del comando ricevuto
-        vector<string> tokens = splitString(input);
+bool sendLoopCommand(const LoopCommand &command)
+{
+    return loopCommands.inserisci(command);
+}
 
-        int argc = tokens.size();
-        char **argv = new char *[argc];
-        for (int i = 0; i < argc; ++i)
+void applyLoopCommands()
+{
+    LoopCommand command;
+    for (int i = 0; i < COMMANDS_PER_SAMPLE && loopCommands.estrai(command); i++)
+    {
+        switch (command.type)
         {
-            argv[i] = new char[tokens[i].size() + 1];
-            std::strcpy(argv[i], tokens[i].c_str());
+        case LoopCommand::REFERENCE:
+            finalReferenceDistance = command.values[0];
+            interpolationActive = true;
+            break;
+        case LoopCommand::CALIBRATION:
+            // La seriale è del thread di acquisizione: la curva è applicata da lì
+            if (SENSOR_THREAD)
+                sensorAcquisition->calibra(command.values[0], command.values[1]);
+            else
+                infraredSensor->useCalibrationCurve(command.values[0], command.values[1]);
+            break;
+        case LoopCommand::PAUSE:
+            controlLoopActive = !controlLoopActive;
+            break;
+        case LoopCommand::STOP:
+            velocity[0] = 0;
+            robot->move_lin_vel_wrf(velocity);
+            robot->deactivate();
+            isRunning = false;
+            controlLoopActive = true;
+            return;
         }
-
-        // Esegui le istruzioni ricevute
-        executeOptions(parseOptionTokens(argc, argv));
     }
 }
 
@@ -314,6 +695,9 @@ void setupSensor()
 {
     infraredSensor = new InfraredSensor(InfraredSensor::USER_INPUT);
     infraredSensor->useCalibrationCurve(1, 0);
+    // Avviata in main dopo il setup: fino ad allora il sensore è letto direttamente
+    if (SENSOR_THREAD)
+        sensorAcquisition = new AcquisizioneSensore(*infraredSensor);
 }
 
 void setupRobot()
@@ -322,32 +706,124 @@ void setupRobot()
     robot->reset_error();
     robot->set_conf(1, 1, -1);
     robot->move_pose(115, -170, 120, 90, 90, 0);
+
+    if (LATENCY_TRACE)
+    {
+        // Il thread EtherCAT completa i record con l'invio del comando e la prima risposta del robot
+        latencyTrace = new TracciaLatenza();
+        robot->set_cycle_callback(TracciaLatenza::cicloEthercat, latencyTrace);
+    }
 }
 
 void setupRegulator()
 {
-    float pole_1 = 0.6;
-    float zero_1 = 0.7967;
-    float gain = 1.6334;
-    vector<float> input_coeff{gain, -gain * zero_1};
-    vector<float> output_coeff{2 * pole_1, -pole_1 * pole_1};
-    regolatore = new Regolatore(output_coeff, input_coeff);
+    // Regolatore tempo continuo equivalente a PROGETTO_REGOLATORE (a 50 Hz):
+    // R(s) = 119.143 (s + 11.3639) / (s + 25.5413)^2, discretizzato con il periodo SAMPLING_TIME
+    FunzioneTrasferimentoContinua regolatoreContinuo = funzioneContinuaProgetto(PROGETTO_REGOLATORE, TEMPO_CAMPIONAMENTO_PROGETTO);
+    CoefficientiRegolatore coefficienti = discretizza(regolatoreContinuo, SAMPLING_TIME, DISCRETIZZAZIONE_POLI_ZERI);
+    activeCoefficients = CoefficientiFissi(coefficienti.output_coeff, coefficienti.input_coeff);
+    if (VARIABLE_SAMPLING_TIME)
+        // Stesso regolatore integrato con il periodo misurato a ogni campione (Tustin a periodo variabile): le sezioni
+        // sono l'inversa di Tustin dei coefficienti, così al periodo nominale l'uscita è quella del periodo fisso
+        regolatore = new VariablePeriodRegulator(continuaDaTustin(coefficienti.output_coeff, coefficienti.input_coeff, SAMPLING_TIME), SAMPLING_TIME);
+    else
+        // Forma di stato con anti-windup a retro-calcolo e ripartenza bumpless
+        regolatore = new FixedPeriodRegulator(coefficienti);
+
+    if (GAIN_SCHEDULING)
+    {
+        setupGainSchedule();
+    }
+
+    if (MODEL_PREDICTIVE_CONTROL)
+    {
+        // Stesso modello identificato del simulatore, con i limiti di posizione del robot
+        ParametriControlloPredittivo parametri;
+        parametri.limiteInferiore = robot->POS_LIMIT_INF;
+        parametri.limiteSuperiore = robot->POS_LIMIT_SUP;
+        controlloPredittivo = new ControlloPredittivo(ParametriMeca500(), SAMPLING_TIME, parametri);
+    }
+
+    // Esperimento a relè preallocato, avviato da --autotune
+    relayExperiment = new EsperimentoRele();
+
+    if (SMITH_PREDICTOR)
+    {
+        // Il tempo morto parte dal ritardo identificato del Meca500 e segue la latenza misurata del sensore
+        predittoreSmith = new PredittoreSmith(ParametriMeca500(), SAMPLING_TIME);
+    }
+
+    if (DISTURBANCE_OBSERVER)
+    {
+        // Filtro inizializzato con l'ostacolo fermo nella posizione misurata all'avvio
+        osservatoreDisturbo = new OsservatoreDisturbo(ParametriMeca500(), SAMPLING_TIME);
+        osservatoreDisturbo->reset(-infraredSensor->getDistanceInMillimeters(), robot->get_position());
+    }
+
+    if (OBSTACLE_ESTIMATOR)
+    {
+        stimatoreOstacolo = new StimatoreOstacolo();
+    }
+
+    if (ITERATIVE_LEARNING)
+    {
+        // Buffer per periodi fino a ParametriApprendimentoIterativo::periodoMassimo, allocati qui
+        apprendimentoIterativo = new ApprendimentoIterativo(SAMPLING_TIME);
+    }
+}
+
+void setupGainSchedule()
+{
+    // Ogni riga è un progetto a 50 Hz nella forma di PROGETTO_REGOLATORE: distance, gain, zero_1 ..., pole_1 ...
+    CsvReader table(GAIN_SCHEDULE_TABLE);
+    const vector<double> &distance = table.column("distance");
+    const vector<double> &gain = table.column("gain");
+    if (table.rows() == 0)
+    {
+        throw runtime_error("Tabella del gain scheduling vuota: " GAIN_SCHEDULE_TABLE);
+    }
+
+    // La tabella deve essere su una griglia uniforme di distanze (ricerca del punto in tempo costante)
+    double step = (table.rows() > 1) ? distance[1] - distance[0] : 1;
+    vector<FunzioneTrasferimentoContinua> designs;
+    for (size_t row = 0; row < table.rows(); row++)
+    {
+        if (fabs(distance[row] - (distance[0] + row * step)) > 1e-3 * step)
+        {
+            throw runtime_error("Le distanze della tabella del gain scheduling devono avere passo costante");
+        }
+        vector<complex<double>> zeros, poles;
+        for (int i = 1; table.has_column("zero_" + to_string(i)); i++)
+        {
+            zeros.push_back(table.column("zero_" + to_string(i))[row]);
+        }
+        for (int i = 1; table.has_column("pole_" + to_string(i)); i++)
+        {
+            poles.push_back(table.column("pole_" + to_string(i))[row]);
+        }
+        designs.push_back(continuaDaPoliZeri(zeros, poles, gain[row], TEMPO_CAMPIONAMENTO_PROGETTO));
+    }
+
+    gainSchedule = new TabellaGuadagni(distance[0], step, designs, SAMPLING_TIME);
+    gainSchedulingActive = true;
+    cout << "Gain scheduling: " << table.rows() << " progetti da " << distance[0] << " mm con passo " << step << " mm\n";
 }
 
 void setupCsvLogger()
 {
     csvLogger = new CsvLogger(csvDataPath.c_str());
-    csvLogger->write("time,reference,position,measured_distance,error,velocity_control\n");
+    csvLogger->write("time,reference,position,measured_distance,error,velocity_control,dt\n");
 }
 
 void writeDataToCsv(float time, float reference, float position, float measured_distance, float error, float velocity_control, CsvLogger &logger)
 {
     logger << current_time;
     logger << currentReferenceDistance;
-    logger << robot->get_position();
+    logger << position;
     logger << currentDistance;
     logger << error;
     logger << output;
+    logger << samplingTime;
     logger.end_row();
 }
 
@@ -358,21 +834,40 @@ void setupCommandHandlers()
     optionHandlers[STOP_COMMAND] = OptionHandler(handleStop, stopMessage.str());
     optionHandlers[CALIBRATION_CURVE_COMMAND] = OptionHandler(handleCalibration, calMessage.str());
     optionHandlers[PAUSE_COMMAND] = OptionHandler(handlePause, pauseMessage.str());
+    optionHandlers[REGULATOR_COMMAND] = OptionHandler(handleRegulator, regMessage.str());
+    optionHandlers[MARGINS_COMMAND] = OptionHandler(handleMargins, marginsMessage.str());
+    optionHandlers[AUTOTUNE_COMMAND] = OptionHandler(handleAutotune, autotuneMessage.str());
+}
+
+string executeCommandLine(const string &line)
+{
+    return executeOptions(parseOptionTokens(splitString(line)));
 }
 
-int executeOptions(map<string, string> options)
+string executeOptions(map<string, string> options)
 {
+    string replies;
     for (auto option : options)
     {
         string optionName = option.first;
         string value = option.second;
-        if (optionHandlers.count(optionName))
+        if (!optionHandlers.count(optionName))
+        {
+            replies += "Comando sconosciuto: --" + optionName + " (--" HELP_COMMAND " per l'elenco)\n";
+            continue;
+        }
+        // Un valore non valido non deve fermare il thread dei comandi
+        try
         {
-            cout << optionHandlers[optionName].handler(value) << endl;
+            replies += optionHandlers[optionName].handler(value) + "\n";
+        }
+        catch (const exception &e)
+        {
+            replies += "Valore non valido per --" + optionName + ": " + value + "\n";
         }
     }
 
-    return 0;
+    return replies;
 }
 string handleHelp(string value)
 {
@@ -381,59 +876,284 @@ string handleHelp(string value)
 
     for (auto option : optionHandlers)
     {
-        cout << option.second.helpMessage;
+        optionMessage << option.second.helpMessage;
     }
     return optionMessage.str();
 }
 string handleStop(string value)
 {
-    cout << "Stopping execution\n";
-    float vel[] = {0, 0, 0, 0, 0, 0};
-    robot->move_lin_vel_wrf(vel);
-    robot->deactivate();
-    isRunning = false;
-    controlLoopActive = true;
-    return "Program stopped successfully";
+    // Il robot è fermato dal ciclo di controllo, unico thread che gli invia comandi
+    if (!sendLoopCommand({LoopCommand::STOP, {0, 0}}))
+        return "Coda dei comandi piena, riprovare";
+    return "Stopping execution";
 }
 
 string handlePause(string value)
 {
-    cout << "Pausing control\n";
+    if (!sendLoopCommand({LoopCommand::PAUSE, {0, 0}}))
+        return "Coda dei comandi piena, riprovare";
+    // Stato prima del comando: la pausa è applicata al prossimo campione
     if (controlLoopActive)
+        return "Pausing control loop type --pause again to resume";
+    return "Resuming control loop...";
+}
+
+string handleRef(string value)
+{
+    stringstream optionMessage;
+    if (!sendLoopCommand({LoopCommand::REFERENCE, {-stof(value), 0}}))
+        return "Coda dei comandi piena, riprovare";
+    optionMessage << left << setw(message_length) << "Riferimento impostato a: " << value << "\n";
+    return optionMessage.str();
+}
+
+string handleCalibration(string value)
+{
+    stringstream optionMessage;
+    vector<float> calibration_values = parseStringToVector(value);
+    if (calibration_values.size() != 2)
     {
-        cout << "Pausing control loop type --pause again to resume" << endl;
+        optionMessage << "Formato non valido, usare --" << CALIBRATION_CURVE_COMMAND << "={m, q}\n";
+        return optionMessage.str();
     }
-    else
+
+    if (!sendLoopCommand({LoopCommand::CALIBRATION, {calibration_values[0], calibration_values[1]}}))
+        return "Coda dei comandi piena, riprovare";
+    optionMessage << left << setw(message_length) << "Parametri calibrazione sensore: " << value << "\n";
+
+    return optionMessage.str();
+}
+
+string handleRegulator(string value)
+{
+    stringstream optionMessage;
+    if (MODEL_PREDICTIVE_CONTROL)
+    {
+        optionMessage << "Coefficienti del regolatore non utilizzati con MODEL_PREDICTIVE_CONTROL\n";
+        return optionMessage.str();
+    }
+    // Testo non nel formato: il motivo è stampato prima del formato atteso
+    vector<vector<double>> groups;
+    try
+    {
+        groups = gruppiGraffe(value);
+    }
+    catch (const invalid_argument &e)
+    {
+        optionMessage << e.what() << "\n";
+    }
+    if (groups.size() < 2 || groups.size() > 3 || (groups.size() == 3 && groups[2].size() != 1))
+    {
+        optionMessage << "Formato non valido, usare --" << REGULATOR_COMMAND << "={b0, b1, ...}{a1, a2, ...}[{fusione}]\n";
+        return optionMessage.str();
+    }
+
+    RegulatorUpdate update;
+    try
+    {
+        update.coefficienti = CoefficientiFissi(groups[1], groups[0]);
+        // Le sezioni continue servono solo al regolatore a periodo variabile: con il periodo fisso non sono
+        // calcolate, così un errore della conversione non può rifiutare coefficienti validi
+        if (VARIABLE_SAMPLING_TIME)
+        {
+            update.sezioni = SezioniContinue(continuaDaTustin(groups[1], groups[0], SAMPLING_TIME));
+        }
+    }
+    catch (const invalid_argument &e)
+    {
+        optionMessage << e.what() << "\n";
+        return optionMessage.str();
+    }
+    update.fusione = (groups.size() == 3) ? groups[2][0] : 1.0;
+    if (update.fusione < 0 || update.fusione > 1)
+    {
+        optionMessage << "La fusione degli stati deve essere compresa tra 0 e 1\n";
+        return optionMessage.str();
+    }
+
+    // Stessa verifica dei poli dei regolatori di --autotune
+    string rejection = checkRegulatorPoles(groups[1]);
+    if (!rejection.empty())
+    {
+        optionMessage << rejection << "\n";
+        return optionMessage.str();
+    }
+
+    // Unico scrittore: il thread dei comandi
+    regulatorUpdates.pubblica(update);
+    activeCoefficients = update.coefficienti;
+    optionMessage << left << setw(message_length) << "Coefficienti regolatore: " << value << "\n";
+    return optionMessage.str();
+}
+
+string checkRegulatorPoles(const vector<double> &outputCoeff)
+{
+    // Rifiuta regolatori instabili o al limite di stabilità: poli del denominatore 1 - a1 z^-1 - ... - an z^-n non
+    // strettamente dentro il cerchio unitario, con margine per l'errore delle radici multiple. Unica eccezione un
+    // solo integratore (polo in z = 1, come nei PID di --autotune): l'uscita resta limitata grazie all'anti-windup
+    // e alla saturazione della velocità, mentre un secondo polo sul cerchio unitario è comunque rifiutato
+    vector<double> denominator{1};
+    for (double a : outputCoeff)
+    {
+        denominator.push_back(-a);
+    }
+    bool integrator = false;
+    for (complex<double> pole : radiciPolinomio(denominator))
     {
-        cout << "Resuming control loop..." << endl;
+        if (!integrator && abs(pole - 1.0) < INTEGRATOR_TOLERANCE)
+        {
+            integrator = true;
+            continue;
+        }
+        if (abs(pole) >= 1 - STABILITY_MARGIN)
+        {
+            stringstream rejection;
+            rejection << "Regolatore instabile o al limite di stabilita', coefficienti non applicati (polo di modulo " << abs(pole) << ")";
+            return rejection.str();
+        }
     }
-    controlLoopActive = !controlLoopActive;
     return "";
 }
 
-string handleRef(string value)
+string handleMargins(string value)
 {
     stringstream optionMessage;
-    optionMessage << left << setw(message_length) << "Riferimento impostato a: " << value << "\n";
-    finalReferenceDistance = -stof(value);
-    interpolationActive = true;
+    CoefficientiFissi coefficients = activeCoefficients;
+    if (!value.empty())
+    {
+        // Testo non nel formato: il motivo è stampato prima del formato atteso
+        vector<vector<double>> groups;
+        try
+        {
+            groups = gruppiGraffe(value);
+        }
+        catch (const invalid_argument &e)
+        {
+            optionMessage << e.what() << "\n";
+        }
+        if (groups.size() != 2)
+        {
+            optionMessage << "Formato non valido, usare --" << MARGINS_COMMAND << "[={b0, b1, ...}{a1, a2, ...}]\n";
+            return optionMessage.str();
+        }
+        try
+        {
+            coefficients = CoefficientiFissi(groups[1], groups[0]);
+        }
+        catch (const invalid_argument &e)
+        {
+            optionMessage << e.what() << "\n";
+            return optionMessage.str();
+        }
+    }
+
+    // Griglia e risposta del modello del Meca500 calcolate alla prima richiesta
+    static RispostaFrequenza frequencyResponse(ParametriMeca500(), SAMPLING_TIME);
+    MarginiStabilita margins = frequencyResponse.margini(coefficients);
+    optionMessage << left << fixed << setprecision(2)
+                  << setw(message_length) << "Margine di fase: " << margins.margineFase << " gradi a " << margins.pulsazioneAttraversamento << " rad/s\n"
+                  << setw(message_length) << "Margine di guadagno: " << margins.margineGuadagno << " dB a " << margins.pulsazioneInversioneFase << " rad/s\n"
+                  << setw(message_length) << "Picco di sensibilita': " << margins.piccoSensibilita << " a " << margins.pulsazionePiccoSensibilita << " rad/s\n";
+    if (gainSchedulingActive)
+    {
+        optionMessage << "Gain scheduling attivo: i margini sono del progetto di base, non di quello interpolato\n";
+    }
     return optionMessage.str();
 }
 
-string handleCalibration(string value)
+string handleAutotune(string value)
 {
     stringstream optionMessage;
-    vector<float> calibration_values = parseStringToVector(value);
+    RegolaTaratura rule = TARATURA_PD;
+    if (!value.empty() && !regolaDaNome(value, rule))
+    {
+        optionMessage << "Regola non valida, usare --" << AUTOTUNE_COMMAND << "[=pd|pid|tl]\n";
+        return optionMessage.str();
+    }
+    if (MODEL_PREDICTIVE_CONTROL)
+    {
+        optionMessage << "Taratura a rele' non disponibile con MODEL_PREDICTIVE_CONTROL\n";
+        return optionMessage.str();
+    }
+    if (!controlLoopActive)
+    {
+        optionMessage << "Ciclo di controllo in pausa, taratura non avviata\n";
+        return optionMessage.str();
+    }
+    AutotuneState expected = AUTOTUNE_IDLE;
+    if (!autotuneState.compare_exchange_strong(expected, AUTOTUNE_REQUESTED))
+    {
+        optionMessage << "Esperimento a rele' gia' in corso\n";
+        return optionMessage.str();
+    }
+
+    // Il thread dei comandi non aspetta: --stop e --pause restano disponibili, il risultato arriva da finishAutotune
+    autotuneRule = rule;
+    return "Esperimento a rele' avviato, i nuovi coefficienti saranno stampati al termine\n";
+}
 
-    if (infraredSensor != nullptr)
+string finishAutotune()
+{
+    stringstream optionMessage;
+    if (autotuneState.exchange(AUTOTUNE_IDLE) != AUTOTUNE_DONE)
     {
-        infraredSensor->useCalibrationCurve(calibration_values[0], calibration_values[1]);
+        optionMessage << "Esperimento a rele' non riuscito, coefficienti non modificati\n";
+        return optionMessage.str();
     }
-    optionMessage << left << setw(message_length) << "Parametri calibrazione sensore: " << value << "\n";
 
+    // Taratura e discretizzazione come in setupRegulator, poi stesso percorso di --reg
+    RisultatoRele result = relayExperiment->getRisultato();
+    RegulatorUpdate update;
+    CoefficientiRegolatore coefficients;
+    try
+    {
+        FunzioneTrasferimentoContinua tuned = taraturaRele(result, autotuneRule);
+        coefficients = discretizza(tuned, SAMPLING_TIME, DISCRETIZZAZIONE_POLI_ZERI);
+        update.coefficienti = CoefficientiFissi(coefficients.output_coeff, coefficients.input_coeff);
+        if (VARIABLE_SAMPLING_TIME)
+        {
+            // Come in setupRegulator: al periodo nominale le sezioni danno gli stessi coefficienti
+            update.sezioni = SezioniContinue(continuaDaTustin(coefficients.output_coeff, coefficients.input_coeff, SAMPLING_TIME));
+        }
+    }
+    catch (const invalid_argument &e)
+    {
+        optionMessage << e.what() << "\n";
+        return optionMessage.str();
+    }
+    // Stessa verifica dei poli di --reg: l'integratore dei PID è ammesso, il resto deve essere stabile
+    string rejection = checkRegulatorPoles(coefficients.output_coeff);
+    if (!rejection.empty())
+    {
+        optionMessage << rejection << "\n";
+        return optionMessage.str();
+    }
+    update.fusione = 1.0;
+    regulatorUpdates.pubblica(update);
+    activeCoefficients = update.coefficienti;
+
+    optionMessage << left << setw(message_length) << "Ciclo limite: " << "ampiezza " << result.ampiezza << " mm, periodo "
+                  << result.periodo << " s\n";
+    optionMessage << left << setw(message_length) << "Punto critico: " << "Ku " << result.guadagnoCritico << " (mm/s)/mm, Tu "
+                  << result.periodoCritico << " s\n";
+    optionMessage << left << setw(message_length) << "Coefficienti regolatore: " << "{";
+    for (size_t i = 0; i < coefficients.input_coeff.size(); i++)
+        optionMessage << (i ? ", " : "") << coefficients.input_coeff[i];
+    optionMessage << "}{";
+    for (size_t i = 0; i < coefficients.output_coeff.size(); i++)
+        optionMessage << (i ? ", " : "") << coefficients.output_coeff[i];
+    optionMessage << "}\n";
     return optionMessage.str();
 }
 
+void failAutotune()
+{
+    // Solo il ciclo di controllo lascia REQUESTED e RUNNING: nessuna corsa con il thread dei comandi
+    AutotuneState state = autotuneState;
+    if (state == AUTOTUNE_REQUESTED || state == AUTOTUNE_RUNNING)
+        autotuneState = AUTOTUNE_FAILED;
+}
+
 void moveRobotToPosition(vector<float> robot_position)
 {
     robot->move_pose(
@@ -466,30 +1186,58 @@ void setupHelpMessages()
     calMessage
         << left
         << "  --" << CALIBRATION_CURVE_COMMAND << setw(optionWidth - strlen(CALIBRATION_CURVE_COMMAND))
-        << "=\"{m, q}\""
+        << "={m, q}"
         << "Specifica i parametri di calibrazione del sensore [default {1, 0} ]" << endl;
+    regMessage
+        << left
+        << "  --" << REGULATOR_COMMAND << setw(optionWidth - strlen(REGULATOR_COMMAND))
+        << "={b0,b1,...}{a1,a2,...}[{fusione}]"
+        << "Cambia i coefficienti del regolatore senza fermare il ciclo di controllo (fusione 1 bumpless [default], 0 stato mantenuto)" << endl;
+    marginsMessage
+        << left
+        << "  --" << MARGINS_COMMAND << setw(optionWidth - strlen(MARGINS_COMMAND))
+        << "[={b0,b1,...}{a1,a2,...}]"
+        << "Margini di fase e di guadagno e picco di sensibilita' con il modello del Meca500 (default regolatore attuale)" << endl;
+    autotuneMessage
+        << left
+        << "  --" << AUTOTUNE_COMMAND << setw(optionWidth - strlen(AUTOTUNE_COMMAND))
+        << "[=pd|pid|tl]"
+        << "Esperimento a rele' attorno al riferimento attuale e nuovi coefficienti con la regola indicata (default pd)" << endl;
 }
 
+// Divide sugli spazi fuori dalle graffe: "--reg={1, 2}{3}" resta un solo token
 vector<std::string> splitString(const string &input)
 {
     vector<std::string> tokens;
-    istringstream iss(input);
     string token;
-    while (getline(iss, token, ' '))
+    int depth = 0;
+    for (char c : input)
     {
-        tokens.push_back(token);
+        if (c == ' ' && depth == 0)
+        {
+            if (!token.empty())
+                tokens.push_back(token);
+            token.clear();
+            continue;
+        }
+        if (c == '{')
+            depth++;
+        else if (c == '}' && depth > 0)
+            depth--;
+        token += c;
     }
+    if (!token.empty())
+        tokens.push_back(token);
     return tokens;
 }
 
-map<string, string> parseOptionTokens(int argc, char *argv[])
+map<string, string> parseOptionTokens(const vector<string> &tokens)
 {
     map<string, string> options;
 
-    for (int i = 0; i < argc; ++i)
+    for (const string &arg : tokens)
     {
-        string arg = argv[i];
-        cout << "Comando ricevuto: " << argv[i] << endl;
+        cout << "Comando ricevuto: " << arg << endl;
         if (arg.substr(0, 2) == "--")
         {
             string command;
@@ -538,9 +1286,70 @@ vector<float> parseStringToVector(string input)
     return result;
 }
 
+
 uint64_t getCurrentTimeMicros()
 {
     return std::chrono::duration_cast<std::chrono::microseconds>(
-               std::chrono::system_clock::now().time_since_epoch())
+               std::chrono::steady_clock::now().time_since_epoch())
         .count();
+}
+
+bool waitForNextSample()
+{
+    if (controlExecutor.attendi())
+        return true;
+
+    // RITARDO_INTERROMPI: campione oltre la scadenza, il robot si ferma e il ciclo termina
+    cout << "Sampling deadline missed.. stopping control loop\n";
+    velocity[0] = 0;
+    robot->move_lin_vel_wrf(velocity);
+    isRunning = false;
+    return false;
+}
+
+float readDistance()
+{
+    if (!SENSOR_THREAD)
+    {
+        sensorRequestTime = getCurrentTimeMicros();
+        float distance = -infraredSensor->getDistanceInMillimeters();
+        sensorReplyTime = getCurrentTimeMicros();
+        return distance;
+    }
+
+    // Ultima misura del thread di acquisizione: l'età della misura è il ritardo del sensore
+    sensorAcquisition->aggiorna();
+    const CampioneSensore &sample = sensorAcquisition->ultimo();
+    sensorRequestTime = sample.richiesta;
+    sensorReplyTime = sample.risposta;
+    if (getCurrentTimeMicros() - sample.richiesta > SENSOR_TIMEOUT * 1e6)
+    {
+        // Sensore bloccato: nessuna misura recente, il robot si ferma come con l'ostacolo fuori portata
+        sensorRequestTime = sensorReplyTime = getCurrentTimeMicros();
+        return -INFINITY;
+    }
+    return -sample.distanza;
+}
+
+void measureSamplingTime()
+{
+    start = getCurrentTimeMicros();
+    if (lastSampleStart != 0)
+    {
+        samplingTime = (start - lastSampleStart) * 1e-6;
+        samplingTimeStats.aggiungi(samplingTime);
+    }
+    else
+    {
+        // Primo campione o ripresa dopo una pausa
+        samplingTime = SAMPLING_TIME;
+    }
+    lastSampleStart = start;
+
+    // Il tempo dei dati di controllo avanza del periodo misurato
+    if (!firstSample)
+    {
+        current_time += samplingTime;
+    }
+    firstSample = false;
 }
\ No newline at end of file
@@ -0,0 +1,100 @@
+/*
+    VALIDAZIONE SIMULATORE:
+
+    1) riproduce i file csv registrati dal ciclo di controllo: la posizione x dell'ostacolo è ricostruita come
+       position - measured_distance, il riferimento è quello registrato e il Meca500 è sostituito dal modello
+       identificato; la posizione simulata del robot è confrontata con quella registrata.
+       Le registrazioni di default (dati_video/data3-5.csv) sono state ottenute con il regolatore di regulator.cpp:
+       y[k] = 4.6129 * u[k] - 3.8864 * u[k-1] + 0.7 * y[k-1]
+    2) misura quanti passi da 20 ms al secondo il simulatore esegue su un core con il regolatore di PROGETTO_REGOLATORE
+
+    uso: valida_simulatore [file.csv ...]
+    ritorna 0 se l'errore quadratico medio di posizione è entro la tolleranza per tutti i file
+*/
+
+#include <SimulatoreAnelloChiuso.hpp>
+#include <Regolatore.hpp>
+#include <ProgettoRegolatore.hpp>
+#include "csvlogger/CsvReader.hpp"
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#define TOLLERANZA_RMS_POSIZIONE_mm 5.0
+#define PASSI_BENCHMARK 10000000
+
+using namespace std;
+
+volatile double sink; // impedisce al compilatore di eliminare il calcolo
+
+int main(int argc, char *argv[])
+{
+    vector<string> files;
+    for (int i = 1; i < argc; i++)
+    {
+        files.push_back(argv[i]);
+    }
+    if (files.empty())
+    {
+        files = {"dati_video/data3.csv", "dati_video/data4.csv", "dati_video/data5.csv"};
+    }
+
+    // Riproduzione delle registrazioni: il rumore del sensore è già contenuto nella posizione ricostruita dell'ostacolo
+    ConfigurazioneSimulazione riproduzione;
+    riproduzione.durataInterpolazione = 0; // il riferimento registrato è già interpolato
+    riproduzione.sensore.deviazioneStandard = 0;
+    riproduzione.sensore.quantizzazione = 0;
+
+    vector<float> input_coeff{4.6129, -3.8864};
+    vector<float> output_coeff{0.7};
+
+    bool ok = true;
+    cout << left << setw(26) << "file" << right << setw(10) << "campioni" << setw(14) << "rms [mm]" << setw(14) << "max [mm]" << endl;
+    for (const string &file : files)
+    {
+        CsvReader reader(file);
+        const vector<double> &position = reader.column("position");
+        const vector<double> &measured_distance = reader.column("measured_distance");
+        const vector<double> &reference = reader.column("reference");
+
+        Regolatore regolatore(output_coeff, input_coeff);
+        SimulatoreAnelloChiuso<Regolatore> simulatore(regolatore, riproduzione, position[0], reference[0]);
+        double sommaQuadrati = 0, erroreMassimo = 0;
+        for (size_t k = 0; k < reader.rows(); k++)
+        {
+            CampioneSimulazione campione = simulatore.passo(position[k] - measured_distance[k], reference[k]);
+            double errore = campione.position - position[k];
+            sommaQuadrati += errore * errore;
+            erroreMassimo = max(erroreMassimo, fabs(errore));
+        }
+        double rms = sqrt(sommaQuadrati / reader.rows());
+        ok = ok && rms <= TOLLERANZA_RMS_POSIZIONE_mm;
+        cout << left << setw(26) << file << right << setw(10) << reader.rows() << setw(14) << setprecision(4) << rms
+             << setw(14) << erroreMassimo << endl;
+    }
+
+    // Velocità di simulazione: ostacolo sinusoidale, sensore con rumore e quantizzazione, regolatore di PROGETTO_REGOLATORE
+    CoefficientiRegolatore progetto = coefficientiProgetto(PROGETTO_REGOLATORE);
+    Regolatore regolatore(progetto.output_coeff, progetto.input_coeff);
+    ConfigurazioneSimulazione configurazione;
+    SimulatoreAnelloChiuso<Regolatore> simulatore(regolatore, configurazione, 115, -50);
+
+    double accumulatore = 0;
+    auto begin = chrono::steady_clock::now();
+    for (int k = 0; k < PASSI_BENCHMARK; k++)
+    {
+        double ostacolo = 165 + 40 * sin(0.02 * k * 0.02 * 2 * M_PI);
+        accumulatore += simulatore.passo(ostacolo, -50).position;
+    }
+    auto end = chrono::steady_clock::now();
+    sink = accumulatore;
+    double secondi = chrono::duration<double>(end - begin).count();
+
+    cout << fixed << setprecision(0);
+    cout << "passi da " << configurazione.tempoCampionamento * 1000 << " ms al secondo: " << PASSI_BENCHMARK / secondi << endl;
+    cout << (ok ? "OK: simulazione entro la tolleranza" : "ERRORE: simulazione fuori tolleranza") << endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,128 @@
+/*
+    VERIFICA BANCO REGOLATORI:
+
+    confronta RegolatoreBank<6, 1, 2> con sei oggetti Regolatore scalari sulle sequenze di errore
+    (riferimento - distanza misurata) registrate in dati_video/data*.csv e misura il tempo per campione di entrambe le soluzioni.
+
+    Ogni canale usa una traccia di errore e un guadagno diversi, a partire dal progetto di setupRegulator().
+
+    uso: verifica_banco_regolatori [cartella_dati]
+    ritorna 0 se tutti i canali coincidono entro la tolleranza
+*/
+
+#include <Regolatore.hpp>
+#include <RegolatoreBank.hpp>
+#include "csvlogger/CsvReader.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#define NUM_CANALI 6
+#define DEFAULT_DATA_FOLDER "dati_video"
+#define TOLLERANZA_RELATIVA 1e-5
+
+using namespace std;
+
+volatile float sink; // impedisce al compilatore di eliminare il calcolo
+
+int main(int argc, char *argv[])
+{
+    string cartella = (argc > 1) ? argv[1] : DEFAULT_DATA_FOLDER;
+    vector<string> files{"data.csv", "data2.csv", "data3.csv", "data4.csv", "data5.csv"};
+
+    // Tracce di errore registrate, una per canale: l'errore è ricalcolato da riferimento e distanza misurata
+    // perché nelle prime registrazioni la colonna error non veniva scritta
+    vector<vector<float>> errori;
+    for (int c = 0; c < NUM_CANALI; c++)
+    {
+        CsvReader reader(cartella + "/" + files[c % files.size()]);
+        const vector<double> &reference = reader.column("reference");
+        const vector<double> &measured_distance = reader.column("measured_distance");
+        vector<float> errore(reader.rows());
+        for (size_t k = 0; k < errore.size(); k++)
+        {
+            errore[k] = reference[k] - measured_distance[k];
+        }
+        errori.push_back(errore);
+    }
+    size_t lunghezza = errori[0].size();
+    for (auto &errore : errori)
+    {
+        lunghezza = min(lunghezza, errore.size());
+    }
+
+    // Progetto di setupRegulator(), con guadagno diverso per ogni canale
+    float pole_1 = 0.6;
+    float zero_1 = 0.7967;
+    RegolatoreBank<NUM_CANALI, 1, 2> banco;
+    vector<Regolatore> regolatori;
+    for (int c = 0; c < NUM_CANALI; c++)
+    {
+        float gain = 1.6334 * (1 + 0.1 * c);
+        vector<float> input_coeff{gain, -gain * zero_1};
+        vector<float> output_coeff{2 * pole_1, -pole_1 * pole_1};
+        regolatori.emplace_back(output_coeff, input_coeff);
+        banco.setCoefficienti(c, {output_coeff[0], output_coeff[1]}, {input_coeff[0], input_coeff[1]});
+    }
+
+    // Confronto campione per campione
+    vector<double> differenzaMassima(NUM_CANALI, 0), uscitaMassima(NUM_CANALI, 0);
+    float ingresso[NUM_CANALI], uscita[NUM_CANALI];
+    for (size_t k = 0; k < lunghezza; k++)
+    {
+        for (int c = 0; c < NUM_CANALI; c++)
+        {
+            ingresso[c] = errori[c][k];
+        }
+        banco.calculate_output(ingresso, uscita);
+        for (int c = 0; c < NUM_CANALI; c++)
+        {
+            float atteso = regolatori[c].calculate_output(ingresso[c]);
+            differenzaMassima[c] = max(differenzaMassima[c], (double)fabs(uscita[c] - atteso));
+            uscitaMassima[c] = max(uscitaMassima[c], (double)fabs(atteso));
+        }
+    }
+
+    bool ok = true;
+    cout << "SIMD: " << SIMD_NOME << ", " << lunghezza << " campioni" << endl;
+    cout << setw(8) << "canale" << setw(20) << "differenza max" << setw(20) << "uscita max" << endl;
+    for (int c = 0; c < NUM_CANALI; c++)
+    {
+        cout << setw(8) << c << setw(20) << differenzaMassima[c] << setw(20) << uscitaMassima[c] << endl;
+        ok = ok && differenzaMassima[c] <= TOLLERANZA_RELATIVA * max(1.0, uscitaMassima[c]);
+    }
+
+    // Tempo per campione: un regolatore scalare, sei regolatori scalari, banco da sei canali
+    const int ripetizioni = 200;
+    float accumulatore = 0;
+    auto misura = [&](auto &&passo)
+    {
+        auto begin = chrono::steady_clock::now();
+        for (int r = 0; r < ripetizioni; r++)
+            for (size_t k = 0; k < lunghezza; k++)
+                passo(k);
+        auto end = chrono::steady_clock::now();
+        return chrono::duration<double, nano>(end - begin).count() / (ripetizioni * lunghezza);
+    };
+    double unoScalare = misura([&](size_t k)
+                               { accumulatore += regolatori[0].calculate_output(errori[0][k]); });
+    double seiScalari = misura([&](size_t k)
+                               { for (int c = 0; c < NUM_CANALI; c++) accumulatore += regolatori[c].calculate_output(errori[c][k]); });
+    double bancoSei = misura([&](size_t k)
+                             {
+                                 for (int c = 0; c < NUM_CANALI; c++) ingresso[c] = errori[c][k];
+                                 banco.calculate_output(ingresso, uscita);
+                                 accumulatore += uscita[0]; });
+    sink = accumulatore;
+
+    cout << fixed << setprecision(2);
+    cout << "ns/campione: 1 Regolatore " << unoScalare << ", " << NUM_CANALI << " Regolatore " << seiScalari
+         << ", RegolatoreBank<" << NUM_CANALI << "> " << bancoSei << endl;
+    cout << (ok ? "OK: il banco coincide con i regolatori scalari" : "ERRORE: il banco differisce dai regolatori scalari") << endl;
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,25 @@
+/*
+    VERIFICA PROGETTO COSTANTE:
+
+    compilato da CMake con try_compile (non è un eseguibile del progetto): make_regulator deve accettare solo
+    progetti valutati a tempo di compilazione.
+
+    CASO_PROGETTO 0: progetto costante stabile, deve compilare
+    CASO_PROGETTO 1: polo instabile scritto come costante, non deve compilare
+    CASO_PROGETTO 2: polo noto solo a tempo di esecuzione, non deve compilare
+*/
+
+#include <ProgettoRegolatore.hpp>
+
+int main(int argc, char *argv[])
+{
+#if CASO_PROGETTO == 0
+    RegolatoreFisso<1, 2> regolatore = make_regulator(PROGETTO_REGOLATORE);
+#elif CASO_PROGETTO == 1
+    RegolatoreFisso<1, 2> regolatore = make_regulator(zeri{0.5}, poli{1.5, 0.2}, guadagno{1});
+#else
+    double polo = 0.1 * argc;
+    RegolatoreFisso<1, 2> regolatore = make_regulator(zeri{0.5}, poli{polo, 0.2}, guadagno{1});
+#endif
+    return regolatore.calculate_output(1) > 0 ? 0 : 1;
+}
@@ -0,0 +1,159 @@
+/*
+    VERIFICA REGOLATORI:
+
+    controlli di regressione sui regolatori della libreria regolatori, senza robot né dati registrati.
+    Ogni controllo stampa OK o ERRORE con il valore trovato.
+
+    uso: verifica_regolatori
+    ritorna 0 se tutti i controlli passano (eseguito da ctest)
+*/
+
+#include <Discretizzazione.hpp>
+#include <GruppiGraffe.hpp>
+#include <ProgettoRegolatore.hpp>
+#include <RegolatoreStatoSpazio.hpp>
+#include <RegolatoreTempoVariabile.hpp>
+#include <TabellaGuadagni.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#define TOLLERANZA 1e-6
+#define TOLLERANZA_RELATIVA 1e-5 // uscite in float
+#define CAMPIONI 500
+
+using namespace std;
+
+int errori = 0;
+
+void verifica(bool condizione, const string &descrizione, double valore)
+{
+    cout << (condizione ? "OK      " : "ERRORE  ") << descrizione << " (" << valore << ")" << endl;
+    if (!condizione)
+    {
+        errori++;
+    }
+}
+
+// Un guadagno puro non ha stato: inizializza() e il cambio di coefficienti non devono lasciare offset
+void verificaGuadagnoPuro()
+{
+    RegolatoreStatoSpazio guadagno(vector<double>{}, vector<double>{2});
+    guadagno.inizializza(5, 0);
+    double uscita = guadagno.calculate_output(1);
+    verifica(fabs(uscita - 2) < TOLLERANZA, "guadagno puro dopo inizializza()", uscita);
+
+    RegolatoreStatoSpazio regolatore(vector<double>{0.5}, vector<double>{1, -0.3});
+    for (int k = 0; k < 20; k++)
+    {
+        regolatore.calculate_output(1);
+    }
+    regolatore.setCoefficienti(vector<double>{}, vector<double>{2}, 0);
+    uscita = regolatore.calculate_output(1);
+    verifica(fabs(uscita - 2) < TOLLERANZA, "guadagno puro dopo il cambio con fusione 0", uscita);
+
+    regolatore.setCoefficienti(vector<double>{0.5}, vector<double>{1, -0.3}, 1);
+    regolatore.setCoefficienti(vector<double>{}, vector<double>{3}, 1);
+    uscita = regolatore.calculate_output(-1);
+    verifica(fabs(uscita + 3) < TOLLERANZA, "guadagno puro dopo il cambio bumpless", uscita);
+}
+
+// Il formato dei coefficienti di --reg, --margins e montecarlo: tutto il testo deve essere letto
+void verificaGruppiGraffe()
+{
+    vector<pair<string, vector<vector<double>>>> validi{
+        {"{1.6334 , -1.30133}{1.2, -0.36}", {{1.6334, -1.30133}, {1.2, -0.36}}},
+        {" { 2 } {} {0.5} ", {{2}, {}, {0.5}}},
+        {"{-1e-3,+2.5E2}{ }", {{-1e-3, 2.5e2}, {}}},
+        {"", {}},
+    };
+    for (const auto &[testo, atteso] : validi)
+    {
+        bool uguale;
+        try
+        {
+            uguale = gruppiGraffe(testo) == atteso;
+        }
+        catch (const invalid_argument &)
+        {
+            uguale = false;
+        }
+        verifica(uguale, "gruppiGraffe accetta \"" + testo + "\"", atteso.size());
+    }
+
+    vector<string> nonValidi{"{1,x,2}{0.5}", "{1;2}{}", "{1 2}{}", "{1,}{}", "{,1}{}", "{1}{2", "{1}x{2}", "reg{1}{2}", "{1}{2}x", "{nan}{}", "{1}{inf}", "{1}}"};
+    for (const string &testo : nonValidi)
+    {
+        size_t gruppi = 0;
+        bool rifiutato = false;
+        try
+        {
+            gruppi = gruppiGraffe(testo).size();
+        }
+        catch (const invalid_argument &)
+        {
+            rifiutato = true;
+        }
+        verifica(rifiutato, "gruppiGraffe rifiuta \"" + testo + "\"", gruppi);
+    }
+}
+
+// Massima differenza, relativa all'uscita massima, tra periodo fisso e periodo variabile con dt = Tc
+double differenzaPeriodi(RegolatoreStatoSpazio &fisso, RegolatoreTempoVariabile &variabile, double tempoCampionamento)
+{
+    double differenza = 0, massimo = 0;
+    for (int k = 0; k < CAMPIONI; k++)
+    {
+        float ingresso = 10 * sin(0.05 * k) + ((k / 100) % 2 ? 5 : -5);
+        float uscitaFissa = fisso.calculate_output(ingresso);
+        float uscitaVariabile = variabile.calculate_output(ingresso, tempoCampionamento);
+        differenza = max(differenza, (double)fabs(uscitaFissa - uscitaVariabile));
+        massimo = max(massimo, (double)fabs(uscitaFissa));
+    }
+    return differenza / massimo;
+}
+
+// Al periodo nominale il regolatore a periodo variabile deve dare l'uscita di quello a periodo fisso, come costruiti
+// da setupRegulator e dalla tabella del gain scheduling
+void verificaPeriodoVariabile()
+{
+    FunzioneTrasferimentoContinua continuo = funzioneContinuaProgetto(PROGETTO_REGOLATORE, TEMPO_CAMPIONAMENTO_PROGETTO);
+    for (double tempoCampionamento : {TEMPO_CAMPIONAMENTO_PROGETTO, 0.01, 0.005})
+    {
+        CoefficientiRegolatore coefficienti = discretizza(continuo, tempoCampionamento, DISCRETIZZAZIONE_POLI_ZERI);
+        RegolatoreStatoSpazio fisso(coefficienti.output_coeff, coefficienti.input_coeff);
+        RegolatoreTempoVariabile variabile(continuaDaTustin(coefficienti.output_coeff, coefficienti.input_coeff, tempoCampionamento), tempoCampionamento);
+        double differenza = differenzaPeriodi(fisso, variabile, tempoCampionamento);
+        verifica(differenza < TOLLERANZA_RELATIVA, "periodo fisso e variabile coincidono a Tc = " + to_string(tempoCampionamento), differenza);
+    }
+
+    // Tabella con due progetti: nel punto della griglia le due interpolazioni sono lo stesso regolatore
+    double tempoCampionamento = 0.01;
+    FunzioneTrasferimentoContinua secondo = continuo;
+    secondo.guadagno *= 1.5;
+    TabellaGuadagni tabella(100, 10, {continuo, secondo}, tempoCampionamento);
+    CoefficientiFissi coefficienti;
+    SezioniContinue sezioni;
+    tabella.interpola(110, coefficienti);
+    tabella.interpola(110, sezioni);
+    RegolatoreStatoSpazio fisso(vector<double>{}, vector<double>{0});
+    fisso.setCoefficienti(coefficienti, 0);
+    RegolatoreTempoVariabile variabile(continuo, tempoCampionamento);
+    variabile.setSezioni(sezioni, 0);
+    double differenza = differenzaPeriodi(fisso, variabile, tempoCampionamento);
+    verifica(differenza < TOLLERANZA_RELATIVA, "periodo fisso e variabile coincidono nella tabella dei guadagni", differenza);
+}
+
+int main()
+{
+    verificaGuadagnoPuro();
+    verificaGruppiGraffe();
+    verificaPeriodoVariabile();
+
+    cout << (errori ? to_string(errori) + " controlli falliti" : "tutti i controlli passati") << endl;
+    return errori ? 1 : 0;
+}